@@ -0,0 +1,576 @@
+// Microbenchmarks of the watch C core on a Linux host: date parsing and
+// formatting, and the task stream (a count message plus batched frames, packed
+// as index.js packs them) for lists of 10, 100 and 1000 tasks.
+//
+//   bench           print the cost per operation and the peak heap
+//   bench --check   fewer iterations; exit non-zero if a result is wrong, a
+//                   cached note is returned for the wrong task, an unchanged
+//                   snapshot is written again, a request is not told it was
+//                   sent or dropped, a page of a paged list completes early
+//                   or late, a streamed list ends before its final length,
+//                   a paged list needs more heap than a short one,
+//                   the sniff interval is not restored after a stream, or a
+//                   row costs more than BENCH_MAX_NS_PER_ROW (if set)
+
+// Pull in the app itself so its static handlers can be driven directly
+#define main pebble_main
+#include "task_manager.c"
+#undef main
+
+#include <pebble_host.h>
+
+// The harness's own buffers do not come out of the app heap
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+
+#define BENCH_DICT_HEADER_SIZE 1
+#define BENCH_TUPLE_HEADER_SIZE 7
+#define BENCH_HEAP_SLACK 1024  // name lengths differ between list sizes
+
+static const int s_list_sizes[] = { 10, 100, 1000 };
+static const char *s_sample_dates[] = {
+  "2026-02-15T14:30:00",
+  "2026-12-31T23:59:59",
+  "2027-01-01T00:00:00",
+  "1767225600",
+  "2026-07-04T09:05:00",
+  "2026-03-29T02:30:00",
+};
+
+static bool s_check;
+static int s_failures;
+static volatile uint32_t s_sink;  // keeps results alive
+
+#define CHECK(condition, ...) do { \
+    if (!(condition)) { \
+      fprintf(stderr, "FAIL: " __VA_ARGS__); \
+      fputc('\n', stderr); \
+      s_failures++; \
+    } \
+  } while (0)
+
+// ============================================
+// Task streams
+// ============================================
+
+typedef struct {
+  uint8_t **messages;
+  uint16_t *sizes;
+  int count;
+  int rows;  // rows sent; longer lists are paged and send one window
+} TaskStream;
+
+static void task_name(int i, char *buffer, size_t size) {
+  static const char *names[] = {
+    "Buy groceries", "Call the dentist about moving the appointment", "Pay rent",
+    "Pick up dry cleaning", "Renew passport", "Water the plants on the balcony",
+  };
+  snprintf(buffer, size, "%s %d", names[i % ARRAY_LENGTH(names)], i);
+}
+
+static uint16_t encode_task(int i, uint8_t *buffer, size_t size) {
+  char name[64];
+  uint8_t uuid[UUID_SIZE];
+  task_name(i, name, sizeof(name));
+  for (int b = 0; b < UUID_SIZE; b++) {
+    uuid[b] = (uint8_t)(i * 31 + b);
+  }
+
+  Record record = {
+    .flags = RECORD_FLAG_UUID_ID | ((i % 4) << RECORD_FLAG_PRIORITY_SHIFT),
+    .due_date = 0,
+    .id = uuid,
+    .id_length = UUID_SIZE,
+    .name = (const uint8_t *)name,
+    .name_length = (uint8_t)strlen(name),
+  };
+  if (i % 3) {
+    record.flags |= RECORD_FLAG_HAS_DUE;
+    record.due_date = 1767225600 + i * 3600;
+  }
+  return record_encode(&record, buffer, size);
+}
+
+static void stream_add(TaskStream *stream, DictionaryIterator *iter) {
+  uint32_t size = dict_write_end(iter);
+  stream->messages = realloc(stream->messages, (stream->count + 1) * sizeof(uint8_t *));
+  stream->sizes = realloc(stream->sizes, (stream->count + 1) * sizeof(uint16_t));
+  stream->messages[stream->count] = (uint8_t *)iter->dictionary;
+  stream->sizes[stream->count] = (uint16_t)size;
+  stream->count++;
+}
+
+static void frame_begin(DictionaryIterator *iter, uint32_t inbox_size, int first) {
+  dict_write_begin(iter, malloc(inbox_size), inbox_size);
+  dict_write_int32(iter, KEY_TYPE, 2);
+  dict_write_int32(iter, KEY_IDX, first);
+  dict_write_uint32(iter, KEY_GENERATION, 0);
+}
+
+// The messages index.js sends for a list of count tasks: the count message,
+// then the first rows packed into frames that fit the watch inbox
+static TaskStream build_task_stream(int count, uint32_t inbox_size) {
+  TaskStream stream = { 0 };
+  stream.rows = count < TASKS_WINDOW_ROWS ? count : TASKS_WINDOW_ROWS;
+
+  uint8_t records[TASKS_WINDOW_ROWS][RECORD_HEADER_SIZE + 2 + 255 + 255];
+  uint16_t lengths[TASKS_WINDOW_ROWS];
+  int arena_size = 0;
+  for (int i = 0; i < stream.rows; i++) {
+    lengths[i] = encode_task(i, records[i], sizeof(records[i]));
+    arena_size += records[i][RECORD_HEADER_SIZE + 1 + UUID_SIZE] + 1;  // name and terminator
+  }
+
+  DictionaryIterator iter;
+  dict_write_begin(&iter, malloc(inbox_size), inbox_size);
+  dict_write_int32(&iter, KEY_TYPE, 2);
+  dict_write_int32(&iter, KEY_COUNT, count);
+  dict_write_int32(&iter, KEY_ARENA_SIZE, arena_size);
+  dict_write_uint32(&iter, KEY_VERSION, 1);
+  dict_write_uint32(&iter, KEY_GENERATION, 0);
+  stream_add(&stream, &iter);
+
+  // Header tuples: type, index, generation and batch
+  const uint32_t header_size = BENCH_DICT_HEADER_SIZE + 4 * (BENCH_TUPLE_HEADER_SIZE + 4);
+  uint32_t frame_size = 0;
+  int batch = 0;
+  for (int i = 0; i < stream.rows; i++) {
+    uint32_t record_size = BENCH_TUPLE_HEADER_SIZE + lengths[i];
+    if (batch && (frame_size + record_size > inbox_size || batch >= MAX_BATCH_RECORDS)) {
+      dict_write_int32(&iter, KEY_BATCH, batch);
+      stream_add(&stream, &iter);
+      batch = 0;
+    }
+    if (!batch) {
+      frame_begin(&iter, inbox_size, i);
+      frame_size = header_size;
+    }
+    dict_write_data(&iter, KEY_RECORD_BASE + batch, records[i], lengths[i]);
+    frame_size += record_size;
+    batch++;
+  }
+  if (batch) {
+    dict_write_int32(&iter, KEY_BATCH, batch);
+    stream_add(&stream, &iter);
+  }
+  return stream;
+}
+
+static void free_task_stream(TaskStream *stream) {
+  for (int i = 0; i < stream->count; i++) {
+    free(stream->messages[i]);
+  }
+  free(stream->messages);
+  free(stream->sizes);
+}
+
+// Stamp the generation the watch asked for on every message of the stream
+static void stream_set_generation(TaskStream *stream, uint32_t generation) {
+  for (int i = 0; i < stream->count; i++) {
+    DictionaryIterator iter;
+    dict_read_begin_from_buffer(&iter, stream->messages[i], stream->sizes[i]);
+    Tuple *tuple = dict_find(&iter, KEY_GENERATION);
+    if (tuple) memcpy(tuple->value->data, &generation, sizeof(generation));
+  }
+}
+
+// Open the benchmark list from the lists menu, as a fresh (unsnapshotted)
+// list, and answer the task request. Returns the generation it carries.
+static uint32_t open_list(void) {
+  Window *tasks_window = task_list_view_get_window();
+  window_stack_remove(tasks_window, false);
+  tasks_free();
+  s_tasks_list_id[0] = '\0';
+
+  MenuIndex index = { 0, 0 };
+  lists_menu_select(s_lists_menu, &index, NULL);
+
+  uint32_t generation = 0;
+  DictionaryIterator *request = host_outbox_pending();
+  if (request) {
+    Tuple *tuple = dict_find(request, KEY_GENERATION);
+    if (tuple) generation = tuple->value->uint32;
+    host_outbox_ack();
+  }
+  return generation;
+}
+
+static void check_tasks(int count, int rows) {
+  CHECK(tasks_count == count, "%d tasks: tasks_count is %d", count, tasks_count);
+  CHECK(s_tasks_received == rows, "%d tasks: received %d rows, expected %d", count, s_tasks_received, rows);
+  for (int i = 0; i < rows; i++) {
+    char expected[64];
+    task_name(i, expected, sizeof(expected));
+    Task *task = task_at(i);
+    CHECK(task && strcmp(task_get_name(task), expected) == 0,
+          "%d tasks: row %d is '%s', expected '%s'", count, i, task ? task_get_name(task) : "(none)", expected);
+    if (!task) break;
+  }
+}
+
+// Long streams run at the reduced sniff interval until they finish, stall or
+// their window is closed; short ones leave it alone
+static void check_bulk_transfer(void) {
+  TaskStream stream = build_task_stream(100, s_inbox_size);
+
+  stream_set_generation(&stream, open_list());
+  host_inbox_deliver(stream.messages[0], stream.sizes[0]);
+  CHECK(host_sniff_interval() == SNIFF_INTERVAL_REDUCED, "100 tasks: sniff interval not reduced");
+  for (int m = 1; m < stream.count; m++) {
+    host_inbox_deliver(stream.messages[m], stream.sizes[m]);
+  }
+  CHECK(host_sniff_interval() == SNIFF_INTERVAL_NORMAL, "sniff interval not restored when the stream finished");
+
+  stream_set_generation(&stream, open_list());
+  host_inbox_deliver(stream.messages[0], stream.sizes[0]);
+  host_timers_run();
+  CHECK(host_sniff_interval() == SNIFF_INTERVAL_NORMAL, "sniff interval not restored when the stream stalled");
+
+  stream_set_generation(&stream, open_list());
+  host_inbox_deliver(stream.messages[0], stream.sizes[0]);
+  window_stack_remove(task_list_view_get_window(), false);
+  CHECK(host_sniff_interval() == SNIFF_INTERVAL_NORMAL, "sniff interval not restored when the window closed");
+  free_task_stream(&stream);
+
+  stream = build_task_stream(10, s_inbox_size);
+  stream_set_generation(&stream, open_list());
+  host_inbox_deliver(stream.messages[0], stream.sizes[0]);
+  CHECK(host_sniff_interval() == SNIFF_INTERVAL_NORMAL, "10 tasks: sniff interval reduced");
+  host_timers_run();
+  free_task_stream(&stream);
+}
+
+// Deliver row i of the benchmark list in a frame of its own
+static void deliver_task_row(int i, uint32_t generation) {
+  uint8_t record[RECORD_HEADER_SIZE + 2 + 255 + 255];
+  uint16_t length = encode_task(i, record, sizeof(record));
+  DictionaryIterator iter;
+  frame_begin(&iter, s_inbox_size, i);
+  dict_write_data(&iter, KEY_RECORD_BASE, record, length);
+  dict_write_int32(&iter, KEY_BATCH, 1);
+  TaskStream frame = { 0 };
+  stream_add(&frame, &iter);
+  stream_set_generation(&frame, generation);
+  host_inbox_deliver(frame.messages[0], frame.sizes[0]);
+  free_task_stream(&frame);
+}
+
+// Length message of a streamed list; with a version, the final one
+static void deliver_task_total(int total, bool final, uint32_t version, uint32_t generation) {
+  uint8_t buffer[64];
+  DictionaryIterator iter;
+  dict_write_begin(&iter, buffer, sizeof(buffer));
+  dict_write_int32(&iter, KEY_TYPE, 2);
+  dict_write_int32(&iter, KEY_TOTAL, total);
+  if (final) dict_write_uint32(&iter, KEY_VERSION, version);
+  dict_write_uint32(&iter, KEY_GENERATION, generation);
+  host_inbox_deliver(buffer, (uint16_t)dict_write_end(&iter));
+}
+
+// Open a streamed list on the watch with the rows known so far
+static uint32_t open_streamed_list(int rows) {
+  uint32_t generation = open_list();
+  uint8_t buffer[64];
+  DictionaryIterator iter;
+  dict_write_begin(&iter, buffer, sizeof(buffer));
+  dict_write_int32(&iter, KEY_TYPE, 2);
+  dict_write_int32(&iter, KEY_COUNT, rows);
+  dict_write_int32(&iter, KEY_ARENA_SIZE, 0);
+  dict_write_uint32(&iter, KEY_VERSION, 0);
+  dict_write_int32(&iter, KEY_TOTAL, 0);
+  dict_write_uint32(&iter, KEY_GENERATION, generation);
+  host_inbox_deliver(buffer, (uint16_t)dict_write_end(&iter));
+  for (int i = 0; i < rows; i++) {
+    deliver_task_row(i, generation);
+  }
+  return generation;
+}
+
+// A list streamed before its length was known arrives as a list of the rows
+// known so far; it only ends with the final KEY_TOTAL, which shrinks a short
+// list to its rows and pages a long one
+static void check_streamed_total(void) {
+  uint32_t generation = open_streamed_list(10);
+  for (int i = 10; i < 20; i++) {
+    deliver_task_row(i, generation);
+  }
+  CHECK(s_tasks_streaming && s_tasks_version == 0, "streamed list finished before its final length");
+  deliver_task_total(20, true, 7, generation);
+  host_timers_run();
+  check_tasks(20, 20);
+  CHECK(tasks_capacity == 20, "short streamed list holds %d slots", tasks_capacity);
+  CHECK(s_tasks_version == 7, "short streamed list has version %lu", (unsigned long)s_tasks_version);
+
+  generation = open_streamed_list(10);
+  for (int i = 10; i < TASKS_WINDOW_ROWS; i++) {
+    deliver_task_row(i, generation);
+  }
+  deliver_task_total(300, false, 0, generation);
+  CHECK(tasks_count == 300, "rows known so far: tasks_count is %d", tasks_count);
+  deliver_task_total(1000, true, 7, generation);
+  host_timers_run();
+  check_tasks(1000, TASKS_WINDOW_ROWS);
+  CHECK(!s_tasks_streaming && s_tasks_pending == 0, "long streamed list: %d rows pending", s_tasks_pending);
+}
+
+// Pages of a paged list wait for their own rows only: rows sent again do not
+// count, and frames after a page is in do not finish the stream again
+static void check_task_pages(void) {
+  TaskStream stream = build_task_stream(1000, s_inbox_size);
+  uint32_t generation = open_list();
+  stream_set_generation(&stream, generation);
+  for (int m = 0; m < stream.count; m++) {
+    host_inbox_deliver(stream.messages[m], stream.sizes[m]);
+  }
+  CHECK(s_tasks_pending == 0, "first window: %d rows pending", s_tasks_pending);
+  deliver_task_row(TASKS_WINDOW_ROWS - 1, generation);
+  CHECK(s_tasks_pending == 0, "row sent again: %d rows pending", s_tasks_pending);
+
+  // Rows 32..47 stay, 48..79 are asked for
+  tasks_ensure_loaded(60);
+  host_outbox_ack();
+  int missing = tasks_first + tasks_capacity - TASKS_WINDOW_ROWS;
+  CHECK(s_tasks_pending == missing, "page: %d rows pending, expected %d", s_tasks_pending, missing);
+  for (int i = tasks_first; i < TASKS_WINDOW_ROWS; i++) {
+    deliver_task_row(i, generation);
+  }
+  CHECK(s_tasks_pending == missing, "held rows counted: %d rows pending, expected %d", s_tasks_pending, missing);
+  for (int i = TASKS_WINDOW_ROWS; i < tasks_first + tasks_capacity; i++) {
+    deliver_task_row(i, generation);
+  }
+  CHECK(s_tasks_pending == 0, "page: %d rows pending after its rows", s_tasks_pending);
+  CHECK(host_sniff_interval() == SNIFF_INTERVAL_NORMAL, "sniff interval not restored after a page");
+  host_timers_run();
+  free_task_stream(&stream);
+}
+
+typedef struct {
+  int messages;
+  double ns_per_message;
+  double ns_per_row;
+  size_t peak_heap;
+  uint32_t reloads;
+  uint32_t rows_drawn;
+} StreamResult;
+
+static StreamResult bench_task_stream(int count, int iterations) {
+  TaskStream stream = build_task_stream(count, s_inbox_size);
+  StreamResult result = { .messages = stream.count };
+  uint64_t elapsed = 0;
+  uint32_t reloads = host_menu_reloads();
+  uint32_t rows_drawn = host_rows_drawn();
+
+  for (int n = 0; n < iterations; n++) {
+    stream_set_generation(&stream, open_list());
+    host_timers_run();
+    host_heap_reset_peak();
+
+    uint64_t start = host_now_ns();
+    for (int m = 0; m < stream.count; m++) {
+      host_inbox_deliver(stream.messages[m], stream.sizes[m]);
+    }
+    host_timers_run();
+    elapsed += host_now_ns() - start;
+
+    if (host_heap_peak() > result.peak_heap) result.peak_heap = host_heap_peak();
+    if (n == 0) check_tasks(count, stream.rows);
+  }
+
+  result.ns_per_message = (double)elapsed / iterations / stream.count;
+  result.ns_per_row = (double)elapsed / iterations / stream.rows;
+  result.reloads = (host_menu_reloads() - reloads) / iterations;
+  result.rows_drawn = (host_rows_drawn() - rows_drawn) / iterations;
+  free_task_stream(&stream);
+  return result;
+}
+
+// ============================================
+// Dates
+// ============================================
+
+static double bench_convert_iso_to_time_t(int iterations) {
+  uint64_t start = host_now_ns();
+  for (int n = 0; n < iterations; n++) {
+    s_sink += (uint32_t)convert_iso_to_time_t(s_sample_dates[n % ARRAY_LENGTH(s_sample_dates)]);
+  }
+  return (double)(host_now_ns() - start) / iterations;
+}
+
+static double bench_convert_iso_to_friendly_date(int iterations) {
+  char buffer[DUE_TEXT_SIZE];
+  uint64_t start = host_now_ns();
+  for (int n = 0; n < iterations; n++) {
+    convert_iso_to_friendly_date(s_sample_dates[n % ARRAY_LENGTH(s_sample_dates)], buffer, sizeof(buffer));
+    s_sink += (uint8_t)buffer[0];
+  }
+  return (double)(host_now_ns() - start) / iterations;
+}
+
+static double bench_format_friendly_date(int iterations) {
+  char buffer[DUE_TEXT_SIZE];
+  time_t today = time_start_of_today();
+  uint64_t start = host_now_ns();
+  for (int n = 0; n < iterations; n++) {
+    format_friendly_date(today + (n % 96) * 3600, false, buffer, sizeof(buffer));
+    s_sink += (uint8_t)buffer[0];
+  }
+  return (double)(host_now_ns() - start) / iterations;
+}
+
+static void check_dates(void) {
+  struct tm expected_tm = { .tm_year = 126, .tm_mon = 1, .tm_mday = 15, .tm_hour = 14, .tm_min = 30, .tm_isdst = -1 };
+  time_t expected = mktime(&expected_tm);
+  CHECK(convert_iso_to_time_t("2026-02-15T14:30:00") == expected, "ISO date parsed as %ld", (long)convert_iso_to_time_t("2026-02-15T14:30:00"));
+  CHECK(convert_iso_to_time_t("1767225600") == 1767225600, "epoch date parsed as %ld", (long)convert_iso_to_time_t("1767225600"));
+  CHECK(convert_iso_to_time_t("") == (time_t)-1, "empty date did not fail");
+  CHECK(convert_iso_to_time_t("2026-02") == (time_t)-1, "short date did not fail");
+
+  char buffer[DUE_TEXT_SIZE];
+  time_t today = time_start_of_today();
+  format_friendly_date(today + 10 * 3600, false, buffer, sizeof(buffer));
+  CHECK(strcmp(buffer, STR_TODAY " 10:00") == 0, "today formatted as '%s'", buffer);
+  format_friendly_date(today + SECONDS_PER_DAY + 60, false, buffer, sizeof(buffer));
+  CHECK(strcmp(buffer, STR_TOMORROW " 00:01") == 0, "tomorrow formatted as '%s'", buffer);
+  format_friendly_date(today + SECONDS_PER_DAY, true, buffer, sizeof(buffer));
+  CHECK(strcmp(buffer, STR_TOMORROW) == 0, "all-day tomorrow formatted as '%s'", buffer);
+  format_friendly_date(0, false, buffer, sizeof(buffer));
+  CHECK(strcmp(buffer, STR_NO_DUE_DATE) == 0, "no due date formatted as '%s'", buffer);
+}
+
+// "AA" and "B " have the same djb2 hash
+static void check_notes_cache(void) {
+  notes_cache_clear();
+  notes_cache_put("AA", "first");
+  const char *notes = notes_cache_get("B ");
+  CHECK(notes == NULL, "notes of a colliding task id returned: '%s'", notes);
+  notes_cache_put("B ", "second");
+  notes = notes_cache_get("AA");
+  CHECK(notes && strcmp(notes, "first") == 0, "notes of 'AA' are '%s'", notes ? notes : "(none)");
+  notes = notes_cache_get("B ");
+  CHECK(notes && strcmp(notes, "second") == 0, "notes of 'B ' are '%s'", notes ? notes : "(none)");
+
+  // UUIDs are kept as their bytes; a lower-case UUID is another id
+  notes_cache_put("0000ABCD-0000-4000-8000-0000000186A0", "uuid");
+  notes = notes_cache_get("0000ABCD-0000-4000-8000-0000000186A0");
+  CHECK(notes && strcmp(notes, "uuid") == 0, "notes of a UUID task are '%s'", notes ? notes : "(none)");
+  notes = notes_cache_get("0000abcd-0000-4000-8000-0000000186a0");
+  CHECK(notes == NULL, "notes of a lower-case UUID returned: '%s'", notes);
+
+  // Long ids are kept by their tail: ones differing only before it stay apart
+  notes_cache_put("x-apple-reminder://LIST-A/TASK-000000001", "long");
+  notes = notes_cache_get("x-apple-reminder://LIST-B/TASK-000000001");
+  CHECK(notes == NULL, "notes of a task id with the same tail returned: '%s'", notes);
+  notes = notes_cache_get("x-apple-reminder://LIST-A/TASK-000000001");
+  CHECK(notes && strcmp(notes, "long") == 0, "notes of a long task id are '%s'", notes ? notes : "(none)");
+  notes_cache_clear();
+}
+
+// Saving the lists again as they are stored writes nothing
+static void check_snapshot_unchanged(void) {
+  snapshot_save_lists();
+  uint32_t writes = host_persist_writes();
+  snapshot_save_lists();
+  CHECK(host_persist_writes() == writes, "unchanged lists snapshot written again (%lu writes)",
+        (unsigned long)(host_persist_writes() - writes));
+  task_lists[0].flags ^= RECORD_FLAG_COMPLETED;
+  snapshot_save_lists();
+  task_lists[0].flags ^= RECORD_FLAG_COMPLETED;
+  CHECK(host_persist_writes() > writes, "changed lists snapshot not written");
+  snapshot_save_lists();
+}
+
+static int s_requests_sent;
+static int s_requests_dropped;
+
+static void count_request_done(bool sent) {
+  if (sent) s_requests_sent++;
+  else s_requests_dropped++;
+}
+
+// Requests learn when they were ACKed or dropped to make room
+static void check_request_done(void) {
+  RequestField fields[] = { REQUEST_UINT(KEY_IDX, 0) };
+  for (int i = 0; i < REQUEST_QUEUE_SIZE; i++) {
+    request_queue_send_notify(8, REQUEST_PRIORITY_TRACE, fields, ARRAY_LENGTH(fields), count_request_done);
+  }
+  request_queue_send(1, REQUEST_PRIORITY_LISTS, fields, ARRAY_LENGTH(fields));
+  CHECK(s_requests_dropped == 1, "%d requests told they were dropped, expected 1", s_requests_dropped);
+  while (host_outbox_pending()) {
+    host_outbox_ack();
+  }
+  CHECK(s_requests_sent == REQUEST_QUEUE_SIZE - 1, "%d requests told they were sent, expected %d",
+        s_requests_sent, REQUEST_QUEUE_SIZE - 1);
+}
+
+// ============================================
+// Main
+// ============================================
+
+// One list to open; the benchmark streams its tasks
+static void add_bench_list(void) {
+  static const char name[] = "Bench";
+  static const char id[] = "bench-list";
+  task_lists_alloc(1, sizeof(name) + sizeof(id));
+  Record record = {
+    .id = (const uint8_t *)id,
+    .id_length = sizeof(id) - 1,
+    .name = (const uint8_t *)name,
+    .name_length = sizeof(name) - 1,
+  };
+  task_list_store_record(0, &record);
+  task_lists_count = 1;
+}
+
+int main(int argc, char **argv) {
+  s_check = argc > 1 && strcmp(argv[1], "--check") == 0;
+  int scale = s_check ? 50 : 1;
+
+  init();
+  add_bench_list();
+  printf("Host build: sizeof(Task) %zu, sizeof(TaskList) %zu, inbox %lu bytes, heap %d bytes\n\n",
+         sizeof(Task), sizeof(TaskList), (unsigned long)s_inbox_size, HOST_HEAP_SIZE);
+
+  check_dates();
+  check_notes_cache();
+  check_snapshot_unchanged();
+  check_request_done();
+  check_bulk_transfer();
+  check_streamed_total();
+  check_task_pages();
+  int date_iterations = 200000 / scale;
+  printf("%-32s %10s\n", "Dates", "ns/op");
+  printf("%-32s %10.0f\n", "convert_iso_to_time_t", bench_convert_iso_to_time_t(date_iterations));
+  printf("%-32s %10.0f\n", "convert_iso_to_friendly_date", bench_convert_iso_to_friendly_date(date_iterations));
+  printf("%-32s %10.0f\n\n", "format_friendly_date", bench_format_friendly_date(date_iterations));
+
+  printf("%-12s %6s %6s %9s %11s %9s %10s %8s\n",
+         "Task stream", "tasks", "rows", "messages", "ns/message", "ns/row", "peak heap", "reloads");
+  size_t peak_heap[ARRAY_LENGTH(s_list_sizes)];
+  for (size_t i = 0; i < ARRAY_LENGTH(s_list_sizes); i++) {
+    int count = s_list_sizes[i];
+    StreamResult result = bench_task_stream(count, 2000 / scale);
+    peak_heap[i] = result.peak_heap;
+    printf("%-12s %6d %6d %9d %11.0f %9.0f %10zu %8u\n", "", count,
+           count < TASKS_WINDOW_ROWS ? count : TASKS_WINDOW_ROWS,
+           result.messages, result.ns_per_message, result.ns_per_row, result.peak_heap, result.reloads);
+
+    const char *max_ns = getenv("BENCH_MAX_NS_PER_ROW");
+    if (s_check && max_ns) {
+      CHECK(result.ns_per_row <= atof(max_ns), "%d tasks: %.0f ns per row exceeds %s", count, result.ns_per_row, max_ns);
+    }
+  }
+
+  // Paging must keep a long list's footprint to that of one window
+  CHECK(peak_heap[2] <= peak_heap[1] + BENCH_HEAP_SLACK,
+        "1000 tasks peak at %zu bytes, 100 tasks at %zu", peak_heap[2], peak_heap[1]);
+
+  deinit();
+  if (s_failures) {
+    fprintf(stderr, "%d check(s) failed\n", s_failures);
+    return 1;
+  }
+  if (s_check) printf("\nAll checks passed\n");
+  return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef PEBBLE_HOST_H
+#define PEBBLE_HOST_H
+
+#include <pebble.h>
+
+// Controls of the host Pebble shim, for benchmarks and checks
+
+// App heap: allocations fail once HOST_HEAP_SIZE bytes (plus a per-block
+// overhead, as on the watch) are in use. AppMessage buffers count against it.
+#define HOST_HEAP_SIZE 65536        // basalt-sized app heap
+#define HOST_HEAP_BLOCK_OVERHEAD 8
+void host_heap_set_size(size_t size);
+size_t host_heap_peak(void);        // most bytes in use since the last reset
+void host_heap_reset_peak(void);
+
+// Rows a menu draws when reloaded (one screen)
+#define HOST_MENU_VISIBLE_ROWS 5
+
+// Deliver a message written with dict_write_begin/dict_write_end to the
+// app's inbox. Returns false if it was dropped (larger than the inbox).
+bool host_inbox_deliver(const uint8_t *message, uint16_t size);
+
+// The message in the outbox, or NULL; acknowledge it to send the next one
+DictionaryIterator *host_outbox_pending(void);
+void host_outbox_ack(void);
+
+// Sniff interval last set with app_comm_set_sniff_interval
+SniffInterval host_sniff_interval(void);
+
+// Fire all registered timers (time does not pass on the host)
+void host_timers_run(void);
+
+// Counters
+uint32_t host_menu_reloads(void);
+uint32_t host_rows_drawn(void);
+uint32_t host_persist_writes(void);  // persist_write_data calls
+
+// Monotonic clock for measurements
+uint64_t host_now_ns(void);
+
+#endif // PEBBLE_HOST_H
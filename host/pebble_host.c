@@ -0,0 +1,803 @@
+#define _POSIX_C_SOURCE 200809L
+#define PEBBLE_HOST_IMPL  // this file allocates with the C library
+#include <pebble.h>
+#include <pebble_host.h>
+#include <stdarg.h>
+
+// ============================================
+// Logging
+// ============================================
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  fprintf(stderr, "[%d] %s:%d: ", log_level, src_filename, src_line_number);
+  vfprintf(stderr, fmt, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+
+// ============================================
+// Heap
+// ============================================
+
+// Each block starts with its size, padded to keep the payload aligned
+typedef union {
+  size_t size;
+  long double align;  // strictest alignment in C99
+} BlockHeader;
+
+static size_t s_heap_size = HOST_HEAP_SIZE;
+static size_t s_heap_used;
+static size_t s_heap_peak;
+
+static size_t block_cost(size_t size) {
+  return size + HOST_HEAP_BLOCK_OVERHEAD;
+}
+
+static bool heap_reserve(size_t cost) {
+  if (s_heap_used + cost > s_heap_size) {
+    return false;
+  }
+  s_heap_used += cost;
+  if (s_heap_used > s_heap_peak) s_heap_peak = s_heap_used;
+  return true;
+}
+
+void *host_malloc(size_t size) {
+  if (!heap_reserve(block_cost(size))) {
+    return NULL;
+  }
+  BlockHeader *block = (BlockHeader *)malloc(sizeof(BlockHeader) + size);
+  if (!block) {
+    s_heap_used -= block_cost(size);
+    return NULL;
+  }
+  block->size = size;
+  return block + 1;
+}
+
+void *host_calloc(size_t count, size_t size) {
+  if (size && count > SIZE_MAX / size) {
+    return NULL;
+  }
+  void *ptr = host_malloc(count * size);
+  if (ptr) memset(ptr, 0, count * size);
+  return ptr;
+}
+
+void host_free(void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  BlockHeader *block = (BlockHeader *)ptr - 1;
+  s_heap_used -= block_cost(block->size);
+  free(block);
+}
+
+void *host_realloc(void *ptr, size_t size) {
+  if (!ptr) {
+    return host_malloc(size);
+  }
+  if (size == 0) {
+    host_free(ptr);
+    return NULL;
+  }
+
+  BlockHeader *block = (BlockHeader *)ptr - 1;
+  size_t old_size = block->size;
+  if (size > old_size && !heap_reserve(size - old_size)) {
+    return NULL;
+  }
+  BlockHeader *resized = (BlockHeader *)realloc(block, sizeof(BlockHeader) + size);
+  if (!resized) {
+    if (size > old_size) s_heap_used -= size - old_size;
+    return NULL;
+  }
+  if (size < old_size) s_heap_used -= old_size - size;
+  resized->size = size;
+  return resized + 1;
+}
+
+size_t heap_bytes_free(void) {
+  return s_heap_size - s_heap_used;
+}
+
+size_t heap_bytes_used(void) {
+  return s_heap_used;
+}
+
+void host_heap_set_size(size_t size) {
+  s_heap_size = size;
+}
+
+size_t host_heap_peak(void) {
+  return s_heap_peak;
+}
+
+void host_heap_reset_peak(void) {
+  s_heap_peak = s_heap_used;
+}
+
+// ============================================
+// Dictionary
+// ============================================
+
+#define TUPLE_HEADER_SIZE sizeof(Tuple)
+
+static Tuple *next_tuple(const Tuple *tuple) {
+  return (Tuple *)((const uint8_t *)tuple + TUPLE_HEADER_SIZE + tuple->length);
+}
+
+static bool tuple_fits(const DictionaryIterator *iter, const Tuple *tuple) {
+  const uint8_t *start = (const uint8_t *)tuple;
+  return start + TUPLE_HEADER_SIZE <= (const uint8_t *)iter->end &&
+         start + TUPLE_HEADER_SIZE + tuple->length <= (const uint8_t *)iter->end;
+}
+
+DictionaryResult dict_write_begin(DictionaryIterator *iter, uint8_t * const buffer, const uint16_t size) {
+  if (!iter || !buffer || size < sizeof(Dictionary)) {
+    return DICT_INVALID_ARGS;
+  }
+  iter->dictionary = (Dictionary *)buffer;
+  iter->dictionary->count = 0;
+  iter->end = buffer + size;
+  iter->cursor = iter->dictionary->head;
+  return DICT_OK;
+}
+
+static DictionaryResult write_tuple(DictionaryIterator *iter, uint32_t key, TupleType type,
+                                    const void *value, uint16_t length) {
+  uint8_t *start = (uint8_t *)iter->cursor;
+  if (start + TUPLE_HEADER_SIZE + length > (uint8_t *)iter->end) {
+    return DICT_NOT_ENOUGH_STORAGE;
+  }
+  iter->cursor->key = key;
+  iter->cursor->type = type;
+  iter->cursor->length = length;
+  memcpy(iter->cursor->value, value, length);
+  iter->cursor = next_tuple(iter->cursor);
+  iter->dictionary->count++;
+  return DICT_OK;
+}
+
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t * const data, const uint16_t size) {
+  return write_tuple(iter, key, TUPLE_BYTE_ARRAY, data, size);
+}
+
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, const uint32_t key, const char * const cstring) {
+  return write_tuple(iter, key, TUPLE_CSTRING, cstring, cstring ? strlen(cstring) + 1 : 0);
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value) {
+  return write_tuple(iter, key, TUPLE_UINT, &value, sizeof(value));
+}
+
+DictionaryResult dict_write_uint16(DictionaryIterator *iter, const uint32_t key, const uint16_t value) {
+  return write_tuple(iter, key, TUPLE_UINT, &value, sizeof(value));
+}
+
+DictionaryResult dict_write_uint32(DictionaryIterator *iter, const uint32_t key, const uint32_t value) {
+  return write_tuple(iter, key, TUPLE_UINT, &value, sizeof(value));
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value) {
+  return write_tuple(iter, key, TUPLE_INT, &value, sizeof(value));
+}
+
+uint32_t dict_write_end(DictionaryIterator *iter) {
+  iter->end = iter->cursor;
+  return (uint32_t)((uint8_t *)iter->cursor - (uint8_t *)iter->dictionary);
+}
+
+Tuple *dict_read_begin_from_buffer(DictionaryIterator *iter, const uint8_t * const buffer, const uint16_t size) {
+  iter->dictionary = (Dictionary *)buffer;
+  iter->end = buffer + size;
+  return dict_read_first(iter);
+}
+
+Tuple *dict_read_first(DictionaryIterator *iter) {
+  iter->cursor = iter->dictionary->head;
+  if (iter->dictionary->count == 0 || !tuple_fits(iter, iter->cursor)) {
+    return NULL;
+  }
+  return iter->cursor;
+}
+
+Tuple *dict_read_next(DictionaryIterator *iter) {
+  Tuple *next = next_tuple(iter->cursor);
+  if (!tuple_fits(iter, next)) {
+    return NULL;
+  }
+  iter->cursor = next;
+  return next;
+}
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key) {
+  Tuple *tuple = iter->dictionary->head;
+  for (int i = 0; i < iter->dictionary->count && tuple_fits(iter, tuple); i++) {
+    if (tuple->key == key) {
+      return tuple;
+    }
+    tuple = next_tuple(tuple);
+  }
+  return NULL;
+}
+
+// ============================================
+// AppMessage
+// ============================================
+
+typedef enum { OUTBOX_IDLE, OUTBOX_WRITING, OUTBOX_SENT } OutboxState;
+
+static AppMessageInboxReceived s_inbox_received;
+static AppMessageInboxDropped s_inbox_dropped;
+static AppMessageOutboxSent s_outbox_sent;
+static AppMessageOutboxFailed s_outbox_failed;
+static uint8_t *s_inbox;
+static uint32_t s_inbox_size;
+static uint8_t *s_outbox;
+static uint32_t s_outbox_size;
+static uint32_t s_outbox_length;
+static OutboxState s_outbox_state;
+static DictionaryIterator s_outbox_iter;
+
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+  AppMessageInboxReceived previous = s_inbox_received;
+  s_inbox_received = received_callback;
+  return previous;
+}
+
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback) {
+  AppMessageInboxDropped previous = s_inbox_dropped;
+  s_inbox_dropped = dropped_callback;
+  return previous;
+}
+
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent sent_callback) {
+  AppMessageOutboxSent previous = s_outbox_sent;
+  s_outbox_sent = sent_callback;
+  return previous;
+}
+
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback) {
+  AppMessageOutboxFailed previous = s_outbox_failed;
+  s_outbox_failed = failed_callback;
+  return previous;
+}
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+  // The buffers come out of the app heap, as on the watch
+  if (s_inbox) {
+    return APP_MSG_INVALID_STATE;
+  }
+  s_inbox = (uint8_t *)host_malloc(size_inbound);
+  s_outbox = (uint8_t *)host_malloc(size_outbound);
+  if (!s_inbox || !s_outbox) {
+    host_free(s_inbox);
+    host_free(s_outbox);
+    s_inbox = s_outbox = NULL;
+    return APP_MSG_OUT_OF_MEMORY;
+  }
+  s_inbox_size = size_inbound;
+  s_outbox_size = size_outbound;
+  return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+  if (!s_outbox) {
+    return APP_MSG_INVALID_STATE;
+  }
+  if (s_outbox_state != OUTBOX_IDLE) {
+    return APP_MSG_BUSY;
+  }
+  dict_write_begin(&s_outbox_iter, s_outbox, s_outbox_size);
+  s_outbox_state = OUTBOX_WRITING;
+  *iterator = &s_outbox_iter;
+  return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+  if (s_outbox_state != OUTBOX_WRITING) {
+    return APP_MSG_INVALID_STATE;
+  }
+  s_outbox_length = dict_write_end(&s_outbox_iter);
+  s_outbox_state = OUTBOX_SENT;
+  return APP_MSG_OK;
+}
+
+uint32_t app_message_inbox_size_maximum(void) {
+  return 8200;
+}
+
+uint32_t app_message_outbox_size_maximum(void) {
+  return 8200;
+}
+
+static SniffInterval s_sniff_interval = SNIFF_INTERVAL_NORMAL;
+
+void app_comm_set_sniff_interval(const SniffInterval interval) {
+  s_sniff_interval = interval;
+}
+
+SniffInterval host_sniff_interval(void) {
+  return s_sniff_interval;
+}
+
+bool host_inbox_deliver(const uint8_t *message, uint16_t size) {
+  if (!s_inbox || size > s_inbox_size) {
+    if (s_inbox_dropped) s_inbox_dropped(APP_MSG_BUFFER_OVERFLOW, NULL);
+    return false;
+  }
+  memcpy(s_inbox, message, size);
+  DictionaryIterator iter;
+  dict_read_begin_from_buffer(&iter, s_inbox, size);
+  if (s_inbox_received) s_inbox_received(&iter, NULL);
+  return true;
+}
+
+DictionaryIterator *host_outbox_pending(void) {
+  static DictionaryIterator iter;
+  if (s_outbox_state != OUTBOX_SENT) {
+    return NULL;
+  }
+  dict_read_begin_from_buffer(&iter, s_outbox, s_outbox_length);
+  return &iter;
+}
+
+void host_outbox_ack(void) {
+  DictionaryIterator *iter = host_outbox_pending();
+  if (!iter) {
+    return;
+  }
+  s_outbox_state = OUTBOX_IDLE;
+  if (s_outbox_sent) s_outbox_sent(iter, NULL);
+}
+
+// ============================================
+// Timers and time
+// ============================================
+
+#define HOST_TIMERS 16
+
+struct AppTimer {
+  AppTimerCallback callback;
+  void *data;
+  bool active;
+};
+
+static AppTimer s_timers[HOST_TIMERS];
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  for (int i = 0; i < HOST_TIMERS; i++) {
+    if (!s_timers[i].active) {
+      s_timers[i] = (AppTimer){ .callback = callback, .data = callback_data, .active = true };
+      return &s_timers[i];
+    }
+  }
+  return NULL;
+}
+
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms) {
+  return timer_handle && timer_handle->active;
+}
+
+void app_timer_cancel(AppTimer *timer_handle) {
+  if (timer_handle) timer_handle->active = false;
+}
+
+void host_timers_run(void) {
+  // Callbacks may register new timers; those fire in the same call
+  bool fired = true;
+  while (fired) {
+    fired = false;
+    for (int i = 0; i < HOST_TIMERS; i++) {
+      if (s_timers[i].active) {
+        s_timers[i].active = false;
+        s_timers[i].callback(s_timers[i].data);
+        fired = true;
+      }
+    }
+  }
+}
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+}
+
+void tick_timer_service_unsubscribe(void) {
+}
+
+uint16_t time_ms(time_t *t_utc, uint16_t *out_ms) {
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  uint16_t ms = (uint16_t)(now.tv_nsec / 1000000);
+  if (t_utc) *t_utc = now.tv_sec;
+  if (out_ms) *out_ms = ms;
+  return ms;
+}
+
+time_t time_start_of_today(void) {
+  // localtime_r, so a struct tm the caller got from localtime() stays intact
+  time_t now = time(NULL);
+  struct tm today;
+  localtime_r(&now, &today);
+  today.tm_hour = 0;
+  today.tm_min = 0;
+  today.tm_sec = 0;
+  return mktime(&today);
+}
+
+bool clock_is_24h_style(void) {
+  return true;
+}
+
+uint64_t host_now_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+// ============================================
+// Persistent storage
+// ============================================
+
+#define HOST_PERSIST_KEYS 64
+#define E_DOES_NOT_EXIST (-4)
+#define E_OUT_OF_STORAGE (-7)
+
+typedef struct {
+  uint32_t key;
+  int length;
+  bool used;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistEntry;
+
+static PersistEntry s_persist[HOST_PERSIST_KEYS];
+static uint32_t s_persist_writes;
+
+static PersistEntry *persist_find(uint32_t key, bool create) {
+  PersistEntry *free_entry = NULL;
+  for (int i = 0; i < HOST_PERSIST_KEYS; i++) {
+    if (s_persist[i].used && s_persist[i].key == key) {
+      return &s_persist[i];
+    }
+    if (!s_persist[i].used && !free_entry) free_entry = &s_persist[i];
+  }
+  if (create && free_entry) {
+    free_entry->used = true;
+    free_entry->key = key;
+    free_entry->length = 0;
+    return free_entry;
+  }
+  return NULL;
+}
+
+bool persist_exists(const uint32_t key) {
+  return persist_find(key, false) != NULL;
+}
+
+int32_t persist_read_int(const uint32_t key) {
+  int32_t value = 0;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+status_t persist_write_int(const uint32_t key, const int32_t value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+  PersistEntry *entry = persist_find(key, false);
+  if (!entry) {
+    return E_DOES_NOT_EXIST;
+  }
+  int length = entry->length < (int)buffer_size ? entry->length : (int)buffer_size;
+  memcpy(buffer, entry->data, length);
+  return length;
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+  PersistEntry *entry = persist_find(key, true);
+  if (!entry) {
+    return E_OUT_OF_STORAGE;
+  }
+  entry->length = size < PERSIST_DATA_MAX_LENGTH ? (int)size : PERSIST_DATA_MAX_LENGTH;
+  memcpy(entry->data, data, entry->length);
+  s_persist_writes++;
+  return entry->length;
+}
+
+status_t persist_delete(const uint32_t key) {
+  PersistEntry *entry = persist_find(key, false);
+  if (!entry) {
+    return E_DOES_NOT_EXIST;
+  }
+  entry->used = false;
+  return 0;
+}
+
+// ============================================
+// App
+// ============================================
+
+void app_event_loop(void) {
+  host_timers_run();
+}
+
+// ============================================
+// UI stubs
+// ============================================
+
+#define HOST_SCREEN GRect(0, 0, 144, 168)
+#define HOST_WINDOW_STACK 8
+
+struct Layer {
+  GRect frame;
+};
+
+struct Window {
+  Layer root;
+  WindowHandlers handlers;
+  bool loaded;
+};
+
+struct MenuLayer {
+  Layer layer;
+  MenuLayerCallbacks callbacks;
+  void *context;
+  MenuIndex selected;
+};
+
+struct StatusBarLayer { Layer layer; };
+struct ScrollLayer { Layer layer; GSize content_size; GPoint offset; };
+struct TextLayer { Layer layer; const char *text; };
+struct ActionBarLayer { Layer layer; };
+struct GBitmap { uint32_t resource_id; };
+
+static Window *s_window_stack[HOST_WINDOW_STACK];
+static int s_window_count;
+static uint32_t s_menu_reloads;
+static uint32_t s_rows_drawn;
+
+void layer_add_child(Layer *parent, Layer *child) {
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+Window *window_create(void) {
+  Window *window = (Window *)calloc(1, sizeof(Window));
+  window->root.frame = HOST_SCREEN;
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (!window) {
+    return;
+  }
+  window_stack_remove(window, false);
+  free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return (Layer *)&window->root;
+}
+
+void window_set_click_config_provider_with_context(Window *window, ClickConfigProvider provider, void *context) {
+}
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler) {
+}
+
+void window_single_repeating_click_subscribe(ButtonId button_id, uint16_t repeat_interval_ms, ClickHandler handler) {
+}
+
+void window_stack_push(Window *window, bool animated) {
+  if (window_stack_contains_window(window) || s_window_count >= HOST_WINDOW_STACK) {
+    return;
+  }
+  s_window_stack[s_window_count++] = window;
+  if (!window->loaded) {
+    window->loaded = true;
+    if (window->handlers.load) window->handlers.load(window);
+  }
+}
+
+Window *window_stack_remove(Window *window, bool animated) {
+  for (int i = 0; i < s_window_count; i++) {
+    if (s_window_stack[i] == window) {
+      memmove(&s_window_stack[i], &s_window_stack[i + 1], (s_window_count - i - 1) * sizeof(Window *));
+      s_window_count--;
+      if (window->loaded) {
+        window->loaded = false;
+        if (window->handlers.unload) window->handlers.unload(window);
+      }
+      return window;
+    }
+  }
+  return NULL;
+}
+
+bool window_stack_contains_window(Window *window) {
+  for (int i = 0; i < s_window_count; i++) {
+    if (s_window_stack[i] == window) return true;
+  }
+  return false;
+}
+
+Window *window_stack_get_top_window(void) {
+  return s_window_count ? s_window_stack[s_window_count - 1] : NULL;
+}
+
+StatusBarLayer *status_bar_layer_create(void) {
+  StatusBarLayer *status_bar = (StatusBarLayer *)calloc(1, sizeof(StatusBarLayer));
+  status_bar->layer.frame = GRect(0, 0, 144, STATUS_BAR_LAYER_HEIGHT);
+  return status_bar;
+}
+
+void status_bar_layer_destroy(StatusBarLayer *status_bar_layer) {
+  free(status_bar_layer);
+}
+
+Layer *status_bar_layer_get_layer(StatusBarLayer *status_bar_layer) {
+  return &status_bar_layer->layer;
+}
+
+MenuLayer *menu_layer_create(GRect frame) {
+  MenuLayer *menu = (MenuLayer *)calloc(1, sizeof(MenuLayer));
+  menu->layer.frame = frame;
+  return menu;
+}
+
+void menu_layer_destroy(MenuLayer *menu_layer) {
+  free(menu_layer);
+}
+
+void menu_layer_set_callbacks(MenuLayer *menu_layer, void *callback_context, MenuLayerCallbacks callbacks) {
+  menu_layer->callbacks = callbacks;
+  menu_layer->context = callback_context;
+}
+
+void menu_layer_set_click_config_onto_window(MenuLayer *menu_layer, Window *window) {
+}
+
+Layer *menu_layer_get_layer(const MenuLayer *menu_layer) {
+  return (Layer *)&menu_layer->layer;
+}
+
+void menu_layer_reload_data(MenuLayer *menu_layer) {
+  // Draw the rows on screen, as the watch does on the next frame
+  s_menu_reloads++;
+  if (!menu_layer->callbacks.get_num_rows || !menu_layer->callbacks.draw_row) {
+    return;
+  }
+  uint16_t rows = menu_layer->callbacks.get_num_rows(menu_layer, 0, menu_layer->context);
+  Layer cell = { GRect(0, 0, menu_layer->layer.frame.size.w, 44) };
+  for (uint16_t row = menu_layer->selected.row; row < rows && row < menu_layer->selected.row + HOST_MENU_VISIBLE_ROWS; row++) {
+    MenuIndex index = { 0, row };
+    menu_layer->callbacks.draw_row(NULL, &cell, &index, menu_layer->context);
+    s_rows_drawn++;
+  }
+}
+
+MenuIndex menu_layer_get_selected_index(const MenuLayer *menu_layer) {
+  return menu_layer->selected;
+}
+
+void menu_cell_basic_draw(GContext *ctx, const Layer *cell_layer, const char *title, const char *subtitle, GBitmap *icon) {
+}
+
+ScrollLayer *scroll_layer_create(GRect frame) {
+  ScrollLayer *scroll = (ScrollLayer *)calloc(1, sizeof(ScrollLayer));
+  scroll->layer.frame = frame;
+  return scroll;
+}
+
+void scroll_layer_destroy(ScrollLayer *scroll_layer) {
+  free(scroll_layer);
+}
+
+Layer *scroll_layer_get_layer(const ScrollLayer *scroll_layer) {
+  return (Layer *)&scroll_layer->layer;
+}
+
+void scroll_layer_add_child(ScrollLayer *scroll_layer, Layer *child) {
+}
+
+void scroll_layer_set_shadow_hidden(ScrollLayer *scroll_layer, bool hidden) {
+}
+
+void scroll_layer_set_content_size(ScrollLayer *scroll_layer, GSize size) {
+  scroll_layer->content_size = size;
+}
+
+GSize scroll_layer_get_content_size(const ScrollLayer *scroll_layer) {
+  return scroll_layer->content_size;
+}
+
+void scroll_layer_set_content_offset(ScrollLayer *scroll_layer, GPoint offset, bool animated) {
+  scroll_layer->offset = offset;
+}
+
+GPoint scroll_layer_get_content_offset(ScrollLayer *scroll_layer) {
+  return scroll_layer->offset;
+}
+
+TextLayer *text_layer_create(GRect frame) {
+  TextLayer *text = (TextLayer *)calloc(1, sizeof(TextLayer));
+  text->layer.frame = frame;
+  return text;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+  free(text_layer);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+  return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+  text_layer->text = text;
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment) {
+}
+
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode) {
+}
+
+GSize text_layer_get_content_size(TextLayer *text_layer) {
+  // Roughly 18 characters per 24 px line
+  int length = text_layer->text ? (int)strlen(text_layer->text) : 0;
+  return GSize(text_layer->layer.frame.size.w, (int16_t)((length / 18 + 1) * 24));
+}
+
+void text_layer_set_size(TextLayer *text_layer, const GSize max_size) {
+  text_layer->layer.frame.size = max_size;
+}
+
+ActionBarLayer *action_bar_layer_create(void) {
+  return (ActionBarLayer *)calloc(1, sizeof(ActionBarLayer));
+}
+
+void action_bar_layer_destroy(ActionBarLayer *action_bar) {
+  free(action_bar);
+}
+
+void action_bar_layer_add_to_window(ActionBarLayer *action_bar, Window *window) {
+}
+
+void action_bar_layer_set_icon(ActionBarLayer *action_bar, ButtonId button_id, const GBitmap *icon) {
+}
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id) {
+  GBitmap *bitmap = (GBitmap *)calloc(1, sizeof(GBitmap));
+  bitmap->resource_id = resource_id;
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  free(bitmap);
+}
+
+uint32_t host_menu_reloads(void) {
+  return s_menu_reloads;
+}
+
+uint32_t host_rows_drawn(void) {
+  return s_rows_drawn;
+}
+
+uint32_t host_persist_writes(void) {
+  return s_persist_writes;
+}
@@ -0,0 +1,52 @@
+#include <pebble.h>
+#include "bulk_transfer.h"
+
+static uint8_t s_active;  // bit (1 << type) per stream in bulk mode
+static AppTimer *s_stall_timer;
+
+static void set_active(uint8_t active) {
+  if (!s_active != !active) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Bulk transfer %s", active ? "started" : "finished");
+    app_comm_set_sniff_interval(active ? SNIFF_INTERVAL_REDUCED : SNIFF_INTERVAL_NORMAL);
+  }
+  s_active = active;
+  if (!active && s_stall_timer) {
+    app_timer_cancel(s_stall_timer);
+    s_stall_timer = NULL;
+  }
+}
+
+static void stall_timer_callback(void *data) {
+  s_stall_timer = NULL;
+  APP_LOG(APP_LOG_LEVEL_WARNING, "Stream stalled, leaving bulk transfer");
+  set_active(0);
+}
+
+static void restart_stall_timer(void) {
+  if (!s_stall_timer || !app_timer_reschedule(s_stall_timer, BULK_TRANSFER_STALL_MS)) {
+    s_stall_timer = app_timer_register(BULK_TRANSFER_STALL_MS, stall_timer_callback, NULL);
+  }
+}
+
+void bulk_transfer_begin(int type, int rows) {
+  if (rows < BULK_TRANSFER_MIN_ROWS) {
+    bulk_transfer_end(type);
+    return;
+  }
+  set_active(s_active | (1 << type));
+  restart_stall_timer();
+}
+
+void bulk_transfer_progress(int type) {
+  if (s_active & (1 << type)) {
+    restart_stall_timer();
+  }
+}
+
+void bulk_transfer_end(int type) {
+  set_active(s_active & ~(1 << type));
+}
+
+void bulk_transfer_deinit(void) {
+  set_active(0);
+}
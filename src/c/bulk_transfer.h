@@ -0,0 +1,31 @@
+#ifndef BULK_TRANSFER_H
+#define BULK_TRANSFER_H
+
+#include <pebble.h>
+
+// Bulk transfer mode: while a long stream arrives, the Bluetooth link runs at
+// the reduced sniff interval, so each message waits less for the radio. It
+// costs battery, so the link returns to normal as soon as no stream needs it.
+// Streams are identified by their message type (1 lists, 2 tasks).
+
+// Streams of at least this many rows enter bulk mode
+#define BULK_TRANSFER_MIN_ROWS 24
+
+// A stream in bulk mode that receives nothing for this long is stalled and
+// leaves it (longer than the phone's largest retry gap)
+#define BULK_TRANSFER_STALL_MS 5000
+
+// A stream announced the rows it will send; enters bulk mode if they are
+// enough, and leaves it otherwise
+void bulk_transfer_begin(int type, int rows);
+
+// A frame of the stream arrived; restarts the stall timeout
+void bulk_transfer_progress(int type);
+
+// The stream finished or is no longer shown
+void bulk_transfer_end(int type);
+
+// Leave bulk mode for all streams
+void bulk_transfer_deinit(void);
+
+#endif // BULK_TRANSFER_H
@@ -0,0 +1,59 @@
+#include <pebble.h>
+#include "menu_redraw.h"
+#include "trace.h"
+
+#define MENU_REDRAW_MAX_MENUS 2
+
+static MenuGetter s_dirty[MENU_REDRAW_MAX_MENUS];
+static int s_dirty_count;
+static AppTimer *s_timer;
+
+static void redraw_timer_callback(void *data) {
+  s_timer = NULL;
+  menu_redraw_flush();
+}
+
+void menu_redraw_schedule(MenuGetter getter) {
+  bool found = false;
+  for (int i = 0; i < s_dirty_count; i++) {
+    if (s_dirty[i] == getter) {
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    if (s_dirty_count >= MENU_REDRAW_MAX_MENUS) {
+      // Should not happen with two menus; reload what we have and start over
+      menu_redraw_flush();
+    }
+    s_dirty[s_dirty_count++] = getter;
+  }
+
+  if (!s_timer) {
+    s_timer = app_timer_register(MENU_REDRAW_INTERVAL_MS, redraw_timer_callback, NULL);
+  }
+}
+
+void menu_redraw_flush(void) {
+  if (s_timer) {
+    app_timer_cancel(s_timer);
+    s_timer = NULL;
+  }
+
+  for (int i = 0; i < s_dirty_count; i++) {
+    MenuLayer *menu = s_dirty[i]();
+    if (menu) {
+      TRACE(TRACE_MENU_RELOAD, 0);
+      menu_layer_reload_data(menu);
+    }
+  }
+  s_dirty_count = 0;
+}
+
+void menu_redraw_cancel(void) {
+  if (s_timer) {
+    app_timer_cancel(s_timer);
+    s_timer = NULL;
+  }
+  s_dirty_count = 0;
+}
@@ -0,0 +1,22 @@
+#ifndef MENU_REDRAW_H
+#define MENU_REDRAW_H
+
+#include <pebble.h>
+
+// Minimum time between coalesced menu reloads (about one frame)
+#define MENU_REDRAW_INTERVAL_MS 33
+
+// Returns the menu to reload, or NULL if its window is not loaded
+typedef MenuLayer* (*MenuGetter)(void);
+
+// Mark a menu dirty; it is reloaded once when the interval elapses, however
+// many times it is marked in between
+void menu_redraw_schedule(MenuGetter getter);
+
+// Reload all dirty menus now (e.g. when a stream completes)
+void menu_redraw_flush(void);
+
+// Drop pending reloads without performing them
+void menu_redraw_cancel(void);
+
+#endif // MENU_REDRAW_H
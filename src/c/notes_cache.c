@@ -0,0 +1,116 @@
+#include <pebble.h>
+#include "notes_cache.h"
+
+#define NOTES_UUID_LENGTH 36  // "XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX"
+
+typedef struct {
+  uint32_t key;        // djb2 hash of the task id, to skip most id compares
+  uint32_t check;      // FNV-1a hash of the task id, for ids kept only in part
+  uint8_t length;      // length of the task id
+  bool uuid;           // id holds the bytes of a canonical UUID
+  uint8_t id[NOTES_ID_SIZE];
+} NotesCacheId;
+
+typedef struct {
+  NotesCacheId id;
+  uint32_t last_used;  // value of s_clock when last read or written, 0 if empty
+  char notes[NOTES_MAX_LENGTH];
+} NotesCacheEntry;
+
+static NotesCacheEntry s_entries[NOTES_CACHE_ENTRIES];
+static uint32_t s_clock;
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// The 16 bytes of a canonical upper-case UUID, as index.js sends them
+static bool parse_uuid(const char *text, size_t length, uint8_t *bytes) {
+  if (length != NOTES_UUID_LENGTH) {
+    return false;
+  }
+  int n = 0;
+  for (size_t i = 0; i < length; i++) {
+    if (i == 8 || i == 13 || i == 18 || i == 23) {
+      if (text[i] != '-') return false;
+      continue;
+    }
+    int high = hex_value(text[i]);
+    int low = hex_value(text[++i]);
+    if (high < 0 || low < 0) return false;
+    bytes[n++] = (uint8_t)(high << 4 | low);
+  }
+  return true;
+}
+
+// The compact form of a task id. UUIDs and ids of up to NOTES_ID_SIZE bytes
+// are kept whole; longer ids by their tail, length and two hashes.
+static bool make_id(const char *task_id, NotesCacheId *id) {
+  size_t length = strlen(task_id);
+  if (length > UINT8_MAX) {
+    return false;
+  }
+  memset(id, 0, sizeof(*id));
+  id->key = 5381;
+  id->check = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    id->key = id->key * 33 + (uint8_t)task_id[i];
+    id->check = (id->check ^ (uint8_t)task_id[i]) * 16777619u;
+  }
+  id->length = (uint8_t)length;
+  id->uuid = parse_uuid(task_id, length, id->id);
+  if (!id->uuid) {
+    size_t kept = length < NOTES_ID_SIZE ? length : NOTES_ID_SIZE;
+    memcpy(id->id, task_id + length - kept, kept);
+  }
+  return true;
+}
+
+static NotesCacheEntry* find_entry(const NotesCacheId *id) {
+  for (int i = 0; i < NOTES_CACHE_ENTRIES; i++) {
+    if (s_entries[i].last_used && memcmp(&s_entries[i].id, id, sizeof(*id)) == 0) {
+      return &s_entries[i];
+    }
+  }
+  return NULL;
+}
+
+void notes_cache_put(const char *task_id, const char *notes) {
+  NotesCacheId id;
+  if (!make_id(task_id, &id)) {
+    // Longer than any id a record can carry
+    return;
+  }
+  NotesCacheEntry *entry = find_entry(&id);
+
+  if (!entry) {
+    // Reuse an empty slot or evict the least recently used one
+    entry = &s_entries[0];
+    for (int i = 1; i < NOTES_CACHE_ENTRIES && entry->last_used; i++) {
+      if (s_entries[i].last_used < entry->last_used) {
+        entry = &s_entries[i];
+      }
+    }
+  }
+
+  memcpy(&entry->id, &id, sizeof(id));  // with its zeroed padding, for memcmp
+  entry->last_used = ++s_clock;
+  snprintf(entry->notes, sizeof(entry->notes), "%s", notes ? notes : "");
+}
+
+const char* notes_cache_get(const char *task_id) {
+  NotesCacheId id;
+  NotesCacheEntry *entry = make_id(task_id, &id) ? find_entry(&id) : NULL;
+  if (!entry) {
+    return NULL;
+  }
+  entry->last_used = ++s_clock;
+  return entry->notes;
+}
+
+void notes_cache_clear(void) {
+  memset(s_entries, 0, sizeof(s_entries));
+  s_clock = 0;
+}
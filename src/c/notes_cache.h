@@ -0,0 +1,22 @@
+#ifndef NOTES_CACHE_H
+#define NOTES_CACHE_H
+
+#include <pebble.h>
+
+// Fixed-memory LRU cache of task notes, keyed by task id. Ids are kept in the
+// compact form of RecordId: canonical UUIDs as 16 bytes, shorter ids as they
+// are, and longer ones as their last 16 bytes plus a second hash.
+#define NOTES_CACHE_ENTRIES 4
+#define NOTES_MAX_LENGTH 256  // including null terminator
+#define NOTES_ID_SIZE 16      // UUID_SIZE
+
+// Store notes for a task, evicting the least recently used entry if full
+void notes_cache_put(const char *task_id, const char *notes);
+
+// Get notes for a task (marking it most recently used), or NULL if not cached
+const char* notes_cache_get(const char *task_id);
+
+// Drop all cached notes
+void notes_cache_clear(void);
+
+#endif // NOTES_CACHE_H
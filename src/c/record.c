@@ -0,0 +1,53 @@
+#include <pebble.h>
+#include "record.h"
+
+bool record_decode(const uint8_t *data, uint16_t length, Record *record) {
+  if (length < RECORD_HEADER_SIZE + 2 || data[0] != RECORD_VERSION) {
+    return false;
+  }
+
+  record->flags = data[1];
+  record->due_date = (time_t)((uint32_t)data[2] |
+                              ((uint32_t)data[3] << 8) |
+                              ((uint32_t)data[4] << 16) |
+                              ((uint32_t)data[5] << 24));
+  if (!(record->flags & RECORD_FLAG_HAS_DUE)) {
+    record->due_date = 0;
+  }
+
+  uint16_t pos = RECORD_HEADER_SIZE;
+  record->id_length = data[pos++];
+  record->id = &data[pos];
+  pos += record->id_length;
+  if (pos >= length) {
+    return false;
+  }
+
+  record->name_length = data[pos++];
+  record->name = &data[pos];
+  pos += record->name_length;
+  return pos <= length;
+}
+
+uint16_t record_encode(const Record *record, uint8_t *buffer, size_t buffer_size) {
+  if ((size_t)RECORD_ENCODED_SIZE(record) > buffer_size) {
+    return 0;
+  }
+
+  uint32_t due = (record->flags & RECORD_FLAG_HAS_DUE) ? (uint32_t)record->due_date : 0;
+  buffer[0] = RECORD_VERSION;
+  buffer[1] = record->flags;
+  buffer[2] = due & 0xFF;
+  buffer[3] = (due >> 8) & 0xFF;
+  buffer[4] = (due >> 16) & 0xFF;
+  buffer[5] = (due >> 24) & 0xFF;
+
+  uint16_t pos = RECORD_HEADER_SIZE;
+  buffer[pos++] = record->id_length;
+  memcpy(&buffer[pos], record->id, record->id_length);
+  pos += record->id_length;
+  buffer[pos++] = record->name_length;
+  memcpy(&buffer[pos], record->name, record->name_length);
+  pos += record->name_length;
+  return pos;
+}
@@ -0,0 +1,41 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <pebble.h>
+
+// Binary record layout (little endian), shared by lists and tasks on the wire
+// and in the persisted snapshot:
+//   [0]    RECORD_VERSION
+//   [1]    flags (RECORD_FLAG_*, priority in bits 1-2)
+//   [2..5] due date, uint32 seconds since epoch (start of the day if RECORD_FLAG_ALL_DAY)
+//   [6]    id length, followed by the UTF-8 id (or 16 raw bytes with RECORD_FLAG_UUID_ID)
+//   [..]   name length, followed by the UTF-8 name
+#define RECORD_VERSION 2
+#define RECORD_HEADER_SIZE 6
+#define RECORD_FLAG_COMPLETED 0x01
+#define RECORD_FLAG_PRIORITY_SHIFT 1
+#define RECORD_FLAG_PRIORITY_MASK 0x06
+#define RECORD_FLAG_HAS_DUE 0x08
+#define RECORD_FLAG_UUID_ID 0x10
+#define RECORD_FLAG_ALL_DAY 0x20  // due on a day, not at a time
+
+// Fields of one binary record; id and name point into the encoded buffer
+typedef struct {
+  uint8_t flags;
+  time_t due_date;
+  const uint8_t *id;
+  uint8_t id_length;
+  const uint8_t *name;
+  uint8_t name_length;
+} Record;
+
+// Bytes a record occupies when encoded
+#define RECORD_ENCODED_SIZE(record) (RECORD_HEADER_SIZE + 2 + (record)->id_length + (record)->name_length)
+
+// Decode a record; returns false if it is truncated or of another version
+bool record_decode(const uint8_t *data, uint16_t length, Record *record);
+
+// Encode a record into buffer; returns the encoded size, or 0 if it does not fit
+uint16_t record_encode(const Record *record, uint8_t *buffer, size_t buffer_size);
+
+#endif // RECORD_H
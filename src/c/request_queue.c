@@ -0,0 +1,212 @@
+#include <pebble.h>
+#include "request_queue.h"
+#include "task_manager.h"
+
+typedef struct {
+  uint8_t type;
+  uint8_t priority;
+  uint8_t field_count;
+  uint8_t attempts;
+  uint32_t sequence;  // enqueue order, for FIFO within a priority
+  RequestDoneHandler done;
+  RequestField fields[REQUEST_MAX_FIELDS];
+} Request;
+
+static Request s_queue[REQUEST_QUEUE_SIZE];
+static int s_count;
+static int s_in_flight = -1;  // index of the request awaiting its ACK
+static uint32_t s_sequence;
+static AppTimer *s_retry_timer;
+
+static void pump(void);
+
+static void free_request(Request *request) {
+  for (int i = 0; i < request->field_count; i++) {
+    if (request->fields[i].text) free((char *)request->fields[i].text);
+  }
+  request->field_count = 0;
+}
+
+static void remove_request(int index) {
+  free_request(&s_queue[index]);
+  s_count--;
+  if (index != s_count) {
+    s_queue[index] = s_queue[s_count];
+    if (s_in_flight == s_count) s_in_flight = index;
+  }
+}
+
+static int next_request(void) {
+  int best = -1;
+  for (int i = 0; i < s_count; i++) {
+    if (best < 0 || s_queue[i].priority > s_queue[best].priority ||
+        (s_queue[i].priority == s_queue[best].priority && s_queue[i].sequence < s_queue[best].sequence)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+static void retry_timer_callback(void *data) {
+  s_retry_timer = NULL;
+  pump();
+}
+
+// Schedule another try of the request, or give up after REQUEST_MAX_ATTEMPTS
+static void retry_later(int index) {
+  Request *request = &s_queue[index];
+  if (++request->attempts >= REQUEST_MAX_ATTEMPTS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Giving up on request type %d", request->type);
+    RequestDoneHandler done = request->done;
+    remove_request(index);
+    if (done) done(false);
+    pump();
+    return;
+  }
+
+  uint32_t delay = REQUEST_RETRY_MS << (request->attempts - 1);
+  if (delay > REQUEST_RETRY_MAX_MS) delay = REQUEST_RETRY_MAX_MS;
+  if (!s_retry_timer) {
+    s_retry_timer = app_timer_register(delay, retry_timer_callback, NULL);
+  }
+}
+
+// Send the most important request if nothing is in flight
+static void pump(void) {
+  if (s_in_flight >= 0 || s_retry_timer || s_count == 0) {
+    return;
+  }
+
+  int index = next_request();
+  Request *request = &s_queue[index];
+  DictionaryIterator *iter;
+  AppMessageResult result = app_message_outbox_begin(&iter);
+  if (result != APP_MSG_OK) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "app_message_outbox_begin failed: %d", (int)result);
+    retry_later(index);
+    return;
+  }
+
+  dict_write_uint8(iter, KEY_TYPE, request->type);
+  for (int i = 0; i < request->field_count; i++) {
+    RequestField *field = &request->fields[i];
+    if (field->data) {
+      dict_write_data(iter, field->key, (const uint8_t *)field->text, field->value);
+    } else if (field->text) {
+      dict_write_cstring(iter, field->key, field->text);
+    } else {
+      dict_write_uint32(iter, field->key, field->value);
+    }
+  }
+
+  result = app_message_outbox_send();
+  if (result != APP_MSG_OK) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "app_message_outbox_send failed: %d", (int)result);
+    retry_later(index);
+    return;
+  }
+  s_in_flight = index;
+}
+
+bool request_queue_send(uint8_t type, RequestPriority priority, const RequestField *fields, int field_count) {
+  return request_queue_send_notify(type, priority, fields, field_count, NULL);
+}
+
+bool request_queue_send_notify(uint8_t type, RequestPriority priority, const RequestField *fields, int field_count,
+                               RequestDoneHandler done) {
+  if (field_count > REQUEST_MAX_FIELDS) {
+    return false;
+  }
+
+  // Told once this request is queued, so that it cannot take the freed slot
+  RequestDoneHandler evicted_done = NULL;
+  if (s_count >= REQUEST_QUEUE_SIZE) {
+    // Make room by dropping the least important request that is not in flight
+    int victim = -1;
+    for (int i = 0; i < s_count; i++) {
+      if (i != s_in_flight && s_queue[i].priority <= priority &&
+          (victim < 0 || s_queue[i].priority < s_queue[victim].priority)) {
+        victim = i;
+      }
+    }
+    if (victim < 0) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Request queue full, dropping type %d", type);
+      return false;
+    }
+    evicted_done = s_queue[victim].done;
+    remove_request(victim);
+  }
+
+  Request *request = &s_queue[s_count];
+  request->type = type;
+  request->priority = priority;
+  request->attempts = 0;
+  request->sequence = s_sequence++;
+  request->done = done;
+  request->field_count = 0;
+  bool ok = true;
+  for (int i = 0; i < field_count; i++) {
+    RequestField *field = &request->fields[request->field_count];
+    field->key = fields[i].key;
+    field->value = fields[i].value;
+    field->text = NULL;
+    field->data = fields[i].data;
+    if (fields[i].text) {
+      size_t length = fields[i].data ? fields[i].value : strlen(fields[i].text) + 1;
+      char *text = (char *)malloc(length);
+      if (!text) {
+        free_request(request);
+        ok = false;
+        break;
+      }
+      memcpy(text, fields[i].text, length);
+      field->text = text;
+    }
+    request->field_count++;
+  }
+  if (ok) {
+    s_count++;
+    pump();
+  }
+
+  if (evicted_done) evicted_done(false);
+  return ok;
+}
+
+void request_queue_cancel(uint8_t type) {
+  for (int i = s_count - 1; i >= 0; i--) {
+    if (i != s_in_flight && s_queue[i].type == type) {
+      remove_request(i);
+    }
+  }
+}
+
+void request_queue_handle_sent(void) {
+  if (s_in_flight >= 0) {
+    int index = s_in_flight;
+    RequestDoneHandler done = s_queue[index].done;
+    s_in_flight = -1;
+    remove_request(index);
+    if (done) done(true);
+  }
+  pump();
+}
+
+void request_queue_handle_failed(AppMessageResult reason) {
+  if (s_in_flight >= 0) {
+    int index = s_in_flight;
+    s_in_flight = -1;
+    retry_later(index);
+  }
+}
+
+void request_queue_clear(void) {
+  if (s_retry_timer) {
+    app_timer_cancel(s_retry_timer);
+    s_retry_timer = NULL;
+  }
+  while (s_count > 0) {
+    remove_request(s_count - 1);
+  }
+  s_in_flight = -1;
+}
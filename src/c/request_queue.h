@@ -0,0 +1,57 @@
+#ifndef REQUEST_QUEUE_H
+#define REQUEST_QUEUE_H
+
+#include <pebble.h>
+
+// Outgoing AppMessage requests. Only one message can be in flight, so
+// requests wait here and are sent highest priority first (oldest first within
+// a priority), retried with backoff when the phone does not acknowledge them.
+#define REQUEST_QUEUE_SIZE 8
+#define REQUEST_MAX_FIELDS 5
+#define REQUEST_MAX_ATTEMPTS 5
+#define REQUEST_RETRY_MS 250      // first retry delay, doubled per attempt
+#define REQUEST_RETRY_MAX_MS 4000
+
+typedef enum {
+  REQUEST_PRIORITY_TRACE,     // diagnostics
+  REQUEST_PRIORITY_LISTS,     // list refresh
+  REQUEST_PRIORITY_TASKS,     // tasks, pages and notes of the list being viewed
+  REQUEST_PRIORITY_CANCEL,    // stop a stream that is no longer wanted
+  REQUEST_PRIORITY_COMPLETE   // user actions; never coalesced
+} RequestPriority;
+
+// One tuple of a request; text and data are copied when the request is queued
+typedef struct {
+  uint32_t key;
+  const char *text;  // string or data value, or NULL for an integer
+  uint32_t value;    // integer value, or length of a data value
+  bool data;
+} RequestField;
+
+#define REQUEST_UINT(k, v) { .key = (k), .text = NULL, .value = (v), .data = false }
+#define REQUEST_CSTRING(k, s) { .key = (k), .text = (s), .value = 0, .data = false }
+#define REQUEST_DATA(k, d, n) { .key = (k), .text = (const char *)(d), .value = (n), .data = true }
+
+// Called once a request was ACKed (sent true), or dropped after
+// REQUEST_MAX_ATTEMPTS or to make room in a full queue (sent false); not
+// called when it is cancelled. It may queue another request.
+typedef void (*RequestDoneHandler)(bool sent);
+
+// Queue a request of the given KEY_TYPE; returns false if it could not be queued
+bool request_queue_send(uint8_t type, RequestPriority priority, const RequestField *fields, int field_count);
+
+// request_queue_send with a handler for when the request is done
+bool request_queue_send_notify(uint8_t type, RequestPriority priority, const RequestField *fields, int field_count,
+                               RequestDoneHandler done);
+
+// Drop queued requests of a type that have not been sent yet
+void request_queue_cancel(uint8_t type);
+
+// Forward the AppMessage outbox callbacks
+void request_queue_handle_sent(void);
+void request_queue_handle_failed(AppMessageResult reason);
+
+// Drop everything (at exit)
+void request_queue_clear(void);
+
+#endif // REQUEST_QUEUE_H
@@ -0,0 +1,185 @@
+#include <pebble.h>
+#include "snapshot.h"
+#include "task_manager.h"
+
+typedef struct {
+  uint8_t version;        // SNAPSHOT_VERSION
+  uint8_t chunks;         // number of chunk keys after the header
+  uint16_t length;        // bytes across all chunks
+  uint16_t count;         // number of records
+  uint16_t arena_size;    // string bytes needed to hold the records
+  uint32_t data_version;  // server change version of the records, 0 if unknown
+} SnapshotHeader;
+
+// Whether the snapshot at key already holds header and the bytes of buffer,
+// compared a chunk at a time so that no second buffer is needed
+static bool snapshot_matches(uint32_t key, const SnapshotHeader *header, const uint8_t *buffer) {
+  SnapshotHeader stored;
+  if (persist_read_data(key, &stored, sizeof(stored)) != (int)sizeof(stored) ||
+      memcmp(&stored, header, sizeof(stored)) != 0) {
+    return false;
+  }
+  uint8_t chunk[PERSIST_DATA_MAX_LENGTH];
+  for (int c = 0; c < header->chunks; c++) {
+    size_t offset = c * PERSIST_DATA_MAX_LENGTH;
+    size_t length = header->length - offset < PERSIST_DATA_MAX_LENGTH ? header->length - offset : PERSIST_DATA_MAX_LENGTH;
+    if (persist_read_data(key + 1 + c, chunk, length) != (int)length ||
+        memcmp(chunk, &buffer[offset], length) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Encode records (prefixed by list_id) into a chunk-sized buffer; records that
+// do not fit in max_chunks are left out. A snapshot that is already stored is
+// not written again, to spare the flash. Returns false if nothing could be written.
+static bool write_snapshot(uint32_t key, int max_chunks, const char *list_id, uint32_t version,
+                           int count, void (*to_record)(int index, Record *record)) {
+  size_t size = max_chunks * PERSIST_DATA_MAX_LENGTH;
+  uint8_t *buffer = (uint8_t *)malloc(size);
+  if (!buffer) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "snapshot: failed to allocate %d bytes", (int)size);
+    return false;
+  }
+
+  size_t id_length = strlen(list_id);
+  buffer[0] = id_length;
+  memcpy(&buffer[1], list_id, id_length);
+  size_t pos = 1 + id_length;
+
+  SnapshotHeader header = { .version = SNAPSHOT_VERSION };
+  for (int i = 0; i < count; i++) {
+    Record record;
+    to_record(i, &record);
+    uint16_t written = record_encode(&record, &buffer[pos], size - pos);
+    if (!written) break;
+    pos += written;
+    header.count++;
+    header.arena_size += record.name_length + 1;
+    if (!(record.flags & RECORD_FLAG_UUID_ID)) {
+      header.arena_size += record.id_length + 1;
+    }
+  }
+  header.length = pos;
+  header.data_version = header.count == count ? version : 0;
+  header.chunks = (pos + PERSIST_DATA_MAX_LENGTH - 1) / PERSIST_DATA_MAX_LENGTH;
+
+  if (snapshot_matches(key, &header, buffer)) {
+    free(buffer);
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "snapshot %d: unchanged, %d records", (int)key, header.count);
+    return true;
+  }
+
+  // Drop the header first so an interrupted write never pairs it with other chunks
+  persist_delete(key);
+  bool ok = true;
+  for (int c = 0; c < header.chunks && ok; c++) {
+    size_t offset = c * PERSIST_DATA_MAX_LENGTH;
+    size_t length = pos - offset < PERSIST_DATA_MAX_LENGTH ? pos - offset : PERSIST_DATA_MAX_LENGTH;
+    ok = persist_write_data(key + 1 + c, &buffer[offset], length) == (int)length;
+  }
+  for (int c = header.chunks; c < max_chunks; c++) {
+    persist_delete(key + 1 + c);
+  }
+  if (ok) {
+    ok = persist_write_data(key, &header, sizeof(header)) == (int)sizeof(header);
+  }
+  free(buffer);
+
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "snapshot %d: saved %d of %d records in %d bytes",
+          (int)key, header.count, count, header.length);
+  return ok;
+}
+
+// Read a snapshot back into a malloc'd buffer; the caller frees it
+static uint8_t* read_snapshot(uint32_t key, int max_chunks, SnapshotHeader *header) {
+  if (persist_read_data(key, header, sizeof(*header)) != (int)sizeof(*header) ||
+      header->version != SNAPSHOT_VERSION || header->chunks > max_chunks || header->length == 0) {
+    return NULL;
+  }
+
+  uint8_t *buffer = (uint8_t *)malloc(header->length);
+  if (!buffer) {
+    return NULL;
+  }
+  for (int c = 0; c < header->chunks; c++) {
+    size_t offset = c * PERSIST_DATA_MAX_LENGTH;
+    size_t length = header->length - offset < PERSIST_DATA_MAX_LENGTH ? header->length - offset : PERSIST_DATA_MAX_LENGTH;
+    if (persist_read_data(key + 1 + c, &buffer[offset], length) != (int)length) {
+      free(buffer);
+      return NULL;
+    }
+  }
+  return buffer;
+}
+
+// Decode the records of a snapshot buffer, starting after the list id.
+// Returns the number of records stored.
+static int read_records(const uint8_t *buffer, const SnapshotHeader *header,
+                        bool (*store)(int index, const Record *record)) {
+  uint16_t pos = 1 + buffer[0];
+  int stored = 0;
+  while (stored < header->count && pos < header->length) {
+    Record record;
+    if (!record_decode(&buffer[pos], header->length - pos, &record) || !store(stored, &record)) {
+      break;
+    }
+    pos += RECORD_ENCODED_SIZE(&record);
+    stored++;
+  }
+  return stored;
+}
+
+static void lists_record_at(int index, Record *record) {
+  task_list_to_record(&task_lists[index], record);
+}
+
+static void tasks_record_at(int index, Record *record) {
+  task_to_record(&tasks[index], record);
+}
+
+void snapshot_save_lists(void) {
+  write_snapshot(SNAPSHOT_LISTS_KEY, SNAPSHOT_LISTS_MAX_CHUNKS, "", 0, task_lists_count, lists_record_at);
+}
+
+void snapshot_save_tasks(const char *list_id, uint32_t version) {
+  write_snapshot(SNAPSHOT_TASKS_KEY, SNAPSHOT_TASKS_MAX_CHUNKS, list_id, version, tasks_count, tasks_record_at);
+}
+
+bool snapshot_load_lists(void) {
+  SnapshotHeader header;
+  uint8_t *buffer = read_snapshot(SNAPSHOT_LISTS_KEY, SNAPSHOT_LISTS_MAX_CHUNKS, &header);
+  if (!buffer) {
+    return false;
+  }
+
+  if (header.count > 0 && task_lists_alloc(header.count, header.arena_size)) {
+    task_lists_count = read_records(buffer, &header, task_list_store_record);
+  }
+  free(buffer);
+
+  APP_LOG(APP_LOG_LEVEL_INFO, "snapshot: loaded %d lists", task_lists_count);
+  return task_lists_count > 0;
+}
+
+bool snapshot_load_tasks(char *list_id, size_t list_id_size, uint32_t *version) {
+  SnapshotHeader header;
+  uint8_t *buffer = read_snapshot(SNAPSHOT_TASKS_KEY, SNAPSHOT_TASKS_MAX_CHUNKS, &header);
+  if (!buffer) {
+    return false;
+  }
+
+  size_t id_length = buffer[0] < list_id_size ? buffer[0] : list_id_size - 1;
+  memcpy(list_id, &buffer[1], id_length);
+  list_id[id_length] = '\0';
+  if (header.count > 0 && tasks_alloc(header.count, header.arena_size)) {
+    tasks_count = read_records(buffer, &header, task_store_record);
+  }
+  free(buffer);
+  *version = tasks_count == header.count ? header.data_version : 0;
+
+  APP_LOG(APP_LOG_LEVEL_INFO, "snapshot: loaded %d tasks of list %s, version %lu",
+          tasks_count, list_id, (unsigned long)*version);
+  return tasks_count > 0;
+}
@@ -0,0 +1,28 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <pebble.h>
+
+// Persisted copy of the last received lists and the last opened list's tasks,
+// shown at launch while the phone revalidates them.
+//
+// Each snapshot is a header at its base key followed by up to *_MAX_CHUNKS
+// chunks of PERSIST_DATA_MAX_LENGTH bytes at base + 1, base + 2, ... The chunks
+// hold the owning list id (tasks only) and then the records in the binary
+// record format (see record.h).
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_LISTS_KEY 1
+#define SNAPSHOT_LISTS_MAX_CHUNKS 4   // 1 KB
+#define SNAPSHOT_TASKS_KEY 16
+#define SNAPSHOT_TASKS_MAX_CHUNKS 8   // 2 KB; longer lists keep their first tasks
+
+// Save task_lists / tasks; call when a stream has completed. The server's change
+// version is only kept if every task fit, as a delta must apply to the full set.
+void snapshot_save_lists(void);
+void snapshot_save_tasks(const char *list_id, uint32_t version);
+
+// Fill task_lists / tasks from the snapshot; returns false if there is none
+bool snapshot_load_lists(void);
+bool snapshot_load_tasks(char *list_id, size_t list_id_size, uint32_t *version);
+
+#endif // SNAPSHOT_H
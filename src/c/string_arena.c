@@ -0,0 +1,67 @@
+#include <pebble.h>
+#include "string_arena.h"
+
+bool string_arena_init(StringArena *arena, size_t size) {
+  arena->data = NULL;
+  arena->used = 0;
+  arena->size = 0;
+
+  if (size == 0) {
+    return true;
+  }
+  if (size >= STRING_ARENA_NONE) {
+    return false;
+  }
+
+  arena->data = (char *)malloc(size);
+  if (!arena->data) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "string_arena_init: failed to allocate %d bytes", (int)size);
+    return false;
+  }
+  arena->size = size;
+  return true;
+}
+
+void string_arena_free(StringArena *arena) {
+  if (arena->data) {
+    free(arena->data);
+  }
+  arena->data = NULL;
+  arena->used = 0;
+  arena->size = 0;
+}
+
+uint16_t string_arena_add(StringArena *arena, const void *src, size_t length) {
+  size_t needed = (size_t)arena->used + length + 1;
+  if (needed >= STRING_ARENA_NONE) {
+    return STRING_ARENA_NONE;
+  }
+
+  if (needed > arena->size) {
+    // Grow by at least a quarter to keep reallocations rare
+    size_t new_size = arena->size + arena->size / 4;
+    if (new_size < needed) new_size = needed;
+    if (new_size >= STRING_ARENA_NONE) new_size = STRING_ARENA_NONE - 1;
+
+    char *data = (char *)realloc(arena->data, new_size);
+    if (!data) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "string_arena_add: failed to grow to %d bytes", (int)new_size);
+      return STRING_ARENA_NONE;
+    }
+    arena->data = data;
+    arena->size = new_size;
+  }
+
+  uint16_t offset = arena->used;
+  memcpy(&arena->data[offset], src, length);
+  arena->data[offset + length] = '\0';
+  arena->used = needed;
+  return offset;
+}
+
+const char* string_arena_get(const StringArena *arena, uint16_t offset) {
+  if (offset == STRING_ARENA_NONE || !arena->data || offset >= arena->used) {
+    return "";
+  }
+  return &arena->data[offset];
+}
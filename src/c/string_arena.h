@@ -0,0 +1,31 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <pebble.h>
+
+// Offset returned when a string could not be stored
+#define STRING_ARENA_NONE 0xFFFF
+
+// One contiguous block of NUL-terminated strings, addressed by offset.
+// Records keep 16-bit offsets instead of pointers so the block can be
+// grown or compacted without fixing up the records.
+typedef struct {
+  char *data;
+  uint16_t used;
+  uint16_t size;
+} StringArena;
+
+// Allocate an arena of the given size (0 allocates nothing until first use)
+bool string_arena_init(StringArena *arena, size_t size);
+
+// Release the arena's memory
+void string_arena_free(StringArena *arena);
+
+// Copy length bytes (plus a terminator) into the arena, growing it if needed.
+// Returns the string's offset or STRING_ARENA_NONE when out of memory.
+uint16_t string_arena_add(StringArena *arena, const void *src, size_t length);
+
+// Get the string stored at offset ("" for STRING_ARENA_NONE)
+const char* string_arena_get(const StringArena *arena, uint16_t offset);
+
+#endif // STRING_ARENA_H
@@ -7,18 +7,22 @@
 // Date and time strings
 #define STR_NO_DUE_DATE "No due date"
 #define STR_INVALID_DATE "Invalid date"
+#define STR_TODAY "Today"
+#define STR_TOMORROW "Tomorrow"
 
 // Task list strings
 #define STR_NO_TASKS "No tasks"
 #define STR_NO_TASKS_IN_LIST "No tasks in list"
 #define STR_LOADING_TASKS "Loading tasks..."
 #define STR_LOADING "Please wait"
+#define STR_LOADING_TASK "Loading..."
 
 // Task status strings
 #define STR_COMPLETED "Completed"
 #define STR_PENDING "Pending"
 
 // Task priority strings
+#define STR_PRIORITY_NONE "None"
 #define STR_PRIORITY_LOW "Low"
 #define STR_PRIORITY_MEDIUM "Medium"
 #define STR_PRIORITY_HIGH "High"
@@ -29,6 +33,7 @@
 #define STR_STATUS_LABEL "Status: "
 #define STR_PRIORITY_LABEL "Priority: "
 #define STR_NOTES_LABEL "Notes: "
+#define STR_LOADING_NOTES "Loading..."
 
 // Instructions
 #define STR_SELECT_TO_MARK_COMPLETE "Select to mark complete"
@@ -2,6 +2,7 @@
 #include "task_manager.h"
 #include "strings.h"
 #include "task_list_view.h"
+#include "notes_cache.h"
 
 // Static variables
 static Window *s_detail_window;
@@ -10,7 +11,8 @@ static ScrollLayer *s_scroll_layer;
 static TextLayer *s_detail_text_layer;
 static ActionBarLayer *s_action_bar;
 static GBitmap *s_checkmark_bitmap;
-static char s_detail_text[256];
+static char s_detail_text[512];
+static char s_task_id[ID_MAX_SIZE];  // id of the task being shown, for matching notes replies
 
 // Forward declarations
 static void detail_window_load(Window *window);
@@ -20,6 +22,15 @@ static void detail_up_click_handler(ClickRecognizerRef recognizer, void *context
 static void detail_down_click_handler(ClickRecognizerRef recognizer, void *context);
 static void detail_click_config_provider(void *context);
 
+static const char* priority_to_string(int priority) {
+  switch (priority) {
+    case PRIORITY_LOW: return STR_PRIORITY_LOW;
+    case PRIORITY_MEDIUM: return STR_PRIORITY_MEDIUM;
+    case PRIORITY_HIGH: return STR_PRIORITY_HIGH;
+    default: return STR_PRIORITY_NONE;
+  }
+}
+
 // Window callbacks
 static void detail_window_load(Window *window) {
   Layer *window_layer = window_get_root_layer(window);
@@ -115,44 +126,61 @@ static void detail_window_unload(Window *window) {
     s_detail_status_bar = NULL;
   }
   text_layer_destroy(s_detail_text_layer);
+  s_detail_text_layer = NULL;
   scroll_layer_destroy(s_scroll_layer);
   action_bar_layer_destroy(s_action_bar);
   gbitmap_destroy(s_checkmark_bitmap);
   // Note: Window itself is destroyed in task_detail_view_deinit(), not here
 }
 
+// Build the detail text for a task, using cached notes when available
+static void format_detail_text(Task *task) {
+  const char *notes = notes_cache_get(s_task_id);
+
+  snprintf(s_detail_text, sizeof(s_detail_text),
+           "%s%s\n\n%s%s\n\n%s%s\n\n%s%s\n\n%s%s\n\n%s",
+           STR_TASK_LABEL, task_get_name(task),
+           STR_DUE_LABEL, task->due_text,
+           STR_STATUS_LABEL, task_is_completed(task) ? STR_COMPLETED : STR_PENDING,
+           STR_PRIORITY_LABEL, priority_to_string(task_get_priority(task)),
+           STR_NOTES_LABEL, notes ? notes : STR_LOADING_NOTES,
+           task_is_completed(task) ? "" : STR_SELECT_TO_MARK_COMPLETE);
+}
+
+// Re-layout the text and scroll layers after s_detail_text changed
+static void update_detail_layout(void) {
+  if (!s_detail_text_layer) {
+    return;
+  }
+  text_layer_set_text(s_detail_text_layer, s_detail_text);
+
+  // Update scroll layer content size
+  GSize text_size = text_layer_get_content_size(s_detail_text_layer);
+  text_layer_set_size(s_detail_text_layer, text_size);
+  GRect scroll_bounds = layer_get_bounds(scroll_layer_get_layer(s_scroll_layer));
+
+  // Account for padding (same calculation as in detail_window_load)
+  #if defined(PBL_ROUND)
+  int padding_vertical = 20;
+  int16_t content_height = padding_vertical + text_size.h + padding_vertical;
+  #else
+  int16_t content_height = 5 + text_size.h + 10;
+  #endif
+  scroll_layer_set_content_size(s_scroll_layer,
+                                 GSize(scroll_bounds.size.w, content_height));
+}
+
 // Click handlers
 static void detail_select_click_handler(ClickRecognizerRef recognizer, void *context) {
-  Task *task = &tasks[selected_task_index];
-  if (!task->completed) {
+  Task *task = task_at(selected_task_index);
+  if (task && !task_is_completed(task)) {
     // Mark task as complete
-    complete_task(task->id, task_lists[selected_list_index].name);
-    task->completed = true;
+    complete_task(s_task_id, task_list_get_name(&task_lists[selected_list_index]));
+    task_set_completed(task);
 
     // Update display
-    static char detail_text[256];
-    convert_iso_to_friendly_date(task->due_date, s_time_buffer, sizeof(s_time_buffer));
-    snprintf(detail_text, sizeof(detail_text),
-             "%s%s\n\n%s%s\n\n%s%s",
-             STR_TASK_LABEL, task->name,
-             STR_DUE_LABEL, s_time_buffer,
-             STR_STATUS_LABEL, STR_COMPLETED);
-    text_layer_set_text(s_detail_text_layer, detail_text);
-
-    // Update scroll layer content size
-    GSize text_size = text_layer_get_content_size(s_detail_text_layer);
-    text_layer_set_size(s_detail_text_layer, text_size);
-    GRect scroll_bounds = layer_get_bounds(scroll_layer_get_layer(s_scroll_layer));
-
-    // Account for padding (same calculation as in detail_window_load)
-    #if defined(PBL_ROUND)
-    int padding_vertical = 20;
-    int16_t content_height = padding_vertical + text_size.h + padding_vertical;
-    #else
-    int16_t content_height = 5 + text_size.h + 10;
-    #endif
-    scroll_layer_set_content_size(s_scroll_layer,
-                                   GSize(scroll_bounds.size.w, content_height));
+    format_detail_text(task);
+    update_detail_layout();
 
     // Update the tasks list
     MenuLayer *tasks_menu = task_list_view_get_menu();
@@ -217,22 +245,31 @@ void task_detail_view_show(Task *task) {
     return;
   }
 
-  // Convert due date to friendly format (handles "No due date" case)
-  convert_iso_to_friendly_date(task->due_date, s_time_buffer, sizeof(s_time_buffer));
+  char id_buffer[UUID_STRING_SIZE];
+  snprintf(s_task_id, sizeof(s_task_id), "%s", task_get_id(task, id_buffer, sizeof(id_buffer)));
 
-  snprintf(s_detail_text, sizeof(s_detail_text),
-           "%s%s\n\n%s%s\n\n%s%s\n\n%s%s\n\n%s%s\n\n%s",
-           STR_TASK_LABEL, task->name,
-           STR_DUE_LABEL, s_time_buffer,
-           STR_STATUS_LABEL, task->completed ? STR_COMPLETED : STR_PENDING,
-           STR_PRIORITY_LABEL, task->priority == 1 ? STR_PRIORITY_LOW : (task->priority == 2 ? STR_PRIORITY_MEDIUM : STR_PRIORITY_HIGH),
-           STR_NOTES_LABEL, task->notes,
-           STR_SELECT_TO_MARK_COMPLETE);
+  // Notes are not part of the list stream; request them unless recently viewed
+  if (!notes_cache_get(s_task_id)) {
+    char list_id[UUID_STRING_SIZE];
+    fetch_task_notes(task_list_get_id(&task_lists[selected_list_index], list_id, sizeof(list_id)), s_task_id);
+  }
+  format_detail_text(task);
 
   // Push window to stack (this will trigger the load callback which sets the text and click config)
   window_stack_push(s_detail_window, true);
 }
 
+void task_detail_view_notes_received(const char *task_id) {
+  if (!s_detail_text_layer || strcmp(task_id, s_task_id) != 0) {
+    return;
+  }
+  Task *task = task_at(selected_task_index);
+  if (task) {
+    format_detail_text(task);
+    update_detail_layout();
+  }
+}
+
 Window* task_detail_view_get_window(void) {
   return s_detail_window;
 }
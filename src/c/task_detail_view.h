@@ -12,6 +12,9 @@ void task_detail_view_deinit(void);
 // Show task detail for the given task
 void task_detail_view_show(Task *task);
 
+// Refresh the detail view if it is showing the task whose notes just arrived
+void task_detail_view_notes_received(const char *task_id);
+
 // Get detail window pointer
 Window* task_detail_view_get_window(void);
 
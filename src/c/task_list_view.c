@@ -2,6 +2,8 @@
 #include "task_manager.h"
 #include "strings.h"
 #include "task_detail_view.h"
+#include "trace.h"
+#include "bulk_transfer.h"
 
 // Static variables
 static Window *s_tasks_window;
@@ -10,14 +12,16 @@ static StatusBarLayer *s_tasks_status_bar;
 
 // Menu callbacks
 static uint16_t tasks_menu_get_num_rows(MenuLayer *menu_layer, uint16_t section_index, void *data) {
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "tasks_menu_get_num_rows called");
+  DRAW_LOG("tasks_menu_get_num_rows called");
   // Return at least 1 row to display "No tasks" message when list is empty
   return tasks_count > 0 ? tasks_count : 1;
 }
 
 static void tasks_menu_draw_row(GContext* ctx, const Layer *cell_layer, MenuIndex *cell_index, void *data) {
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "tasks_menu_draw_row called for row %d", cell_index->row);
+  DRAW_LOG("tasks_menu_draw_row called for row %d", cell_index->row);
+  TRACE(TRACE_DRAW_ROW, cell_index->row);
 
+  Task *task;
   if (tasks_count == 0) {
     // Show loading message if we're waiting for tasks, otherwise show "no tasks"
     if (tasks_loading) {
@@ -25,16 +29,16 @@ static void tasks_menu_draw_row(GContext* ctx, const Layer *cell_layer, MenuInde
     } else {
       menu_cell_basic_draw(ctx, cell_layer, STR_NO_TASKS, STR_NO_TASKS_IN_LIST, NULL);
     }
-    return;
+  } else if ((task = task_at(cell_index->row))) {
+    // Due text is rendered when the task arrives, never while drawing
+    const char *subtitle = task_is_completed(task) ? STR_COMPLETED : task->due_text;
+    menu_cell_basic_draw(ctx, cell_layer, task_get_name(task), subtitle, NULL);
+  } else if (cell_index->row < tasks_count) {
+    // Row of a paged list that has not arrived yet
+    menu_cell_basic_draw(ctx, cell_layer, STR_LOADING_TASK, NULL, NULL);
   }
 
-  if (cell_index->row < tasks_count) {
-    Task *task = &tasks[cell_index->row];
-    convert_iso_to_friendly_date(task->due_date, s_time_buffer, sizeof(s_time_buffer));
-
-    const char *subtitle = task->completed ? STR_COMPLETED : s_time_buffer;
-    menu_cell_basic_draw(ctx, cell_layer, task->name, subtitle, NULL);
-  }
+  TRACE(TRACE_DRAW_ROW_DONE, cell_index->row);
 }
 
 static void tasks_menu_select(MenuLayer *menu_layer, MenuIndex *cell_index, void *data) {
@@ -51,14 +55,26 @@ static void tasks_menu_select(MenuLayer *menu_layer, MenuIndex *cell_index, void
     return;
   }
 
+  Task *task = task_at(cell_index->row);
+  if (!task) {
+    return;
+  }
+
   selected_task_index = cell_index->row;
-  task_detail_view_show(&tasks[selected_task_index]);
+  task_detail_view_show(task);
+}
+
+static void tasks_menu_selection_changed(MenuLayer *menu_layer, MenuIndex new_index, MenuIndex old_index, void *data) {
+  // Page in the rows around the selection of a long list
+  tasks_ensure_loaded(new_index.row);
 }
 
 // Window callbacks
 static void tasks_window_unload(Window *window) {
   // When tasks window is closed we should return to lists state
   current_state = STATE_TASK_LISTS;
+  // The rest of its stream is no longer worth the radio time
+  bulk_transfer_end(2);
   if (s_tasks_status_bar) {
     status_bar_layer_destroy(s_tasks_status_bar);
     s_tasks_status_bar = NULL;
@@ -87,6 +103,7 @@ static void tasks_window_load(Window *window) {
     .get_num_rows = tasks_menu_get_num_rows,
     .draw_row = tasks_menu_draw_row,
     .select_click = tasks_menu_select,
+    .selection_changed = tasks_menu_selection_changed,
   });
   menu_layer_set_click_config_onto_window(s_tasks_menu, window);
   layer_add_child(window_layer, menu_layer_get_layer(s_tasks_menu));
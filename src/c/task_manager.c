@@ -6,6 +6,28 @@
 #include "task_list_view.h"
 #include "task_detail_view.h"
 #include "strings.h"
+#include "string_arena.h"
+#include "notes_cache.h"
+#include "menu_redraw.h"
+#include "record.h"
+#include "snapshot.h"
+#include "request_queue.h"
+#include "trace.h"
+#include "bulk_transfer.h"
+
+// Rows that fill the first screen of a menu; reaching it triggers an immediate redraw
+#define FIRST_SCREEN_ROWS 5
+
+// AppMessage buffers. The inbox gets a share of the heap left at startup, so
+// platforms with room receive bigger frames; aplite stays small.
+#define APP_MESSAGE_OUTBOX_SIZE 512
+#define APP_MESSAGE_INBOX_MIN 512
+#define APP_MESSAGE_HEAP_SHARE 4  // at most a quarter of the free heap
+#if defined(PBL_PLATFORM_APLITE)
+#define APP_MESSAGE_INBOX_CAP 1024
+#else
+#define APP_MESSAGE_INBOX_CAP 8192
+#endif
 
 // Windows
 static Window *s_lists_window;
@@ -17,14 +39,44 @@ AppState current_state = STATE_TASK_LISTS;
 TaskList *task_lists = NULL;
 int task_lists_count = 0;
 int task_lists_capacity = 0;
+StringArena task_lists_arena;
 Task *tasks = NULL;
 int tasks_count = 0;
 int tasks_capacity = 0;
+int tasks_first = 0;
+StringArena tasks_arena;
 int selected_list_index = 0;
 int selected_task_index = 0;
 bool js_ready = false;  // set when JS signals it's ready
 bool tasks_loading = false;  // Flag to track if tasks are being fetched
-char s_time_buffer[32]; // Buffer for formatted dates
+static bool s_clock_24h;  // clock style the due texts were rendered with
+static uint32_t s_inbox_size;  // chosen at startup, reported to the phone with each fetch
+
+// Revalidation of snapshot data: rows are stale until the stream overwrites
+// them, and *_received is one past the highest record index received
+static bool s_lists_stale;
+static bool s_tasks_stale;
+static int s_lists_received;
+static int s_tasks_received;
+static char s_tasks_list_id[ID_MAX_SIZE];  // list the tasks[] records belong to
+
+// Delta sync: server change version of the complete tasks[] set (0 while a
+// stream is incomplete), the version being streamed, and rows still to arrive
+// for the stream or, once a paged list's first window is in, the last page
+static uint32_t s_tasks_version;
+static uint32_t s_tasks_stream_version;
+static int s_tasks_pending;
+static bool s_tasks_streaming;  // rows still come in as the server delivers them
+
+// Generation of the current list and task streams (see KEY_GENERATION)
+static uint32_t s_generation;
+static uint32_t s_lists_generation;
+static uint32_t s_tasks_generation;
+static uint32_t s_cancelled_generation;  // last stale generation we asked to stop
+
+// Rows of the last page request, so scrolling within it does not repeat it
+static int s_page_request_first;
+static int s_page_request_count;
 
 //#define TESTING 1
 #ifdef TESTING
@@ -57,15 +109,17 @@ static void fetch_tasks_testing(void);
 // Menu callbacks
 // Lists menu callbacks
 static uint16_t lists_menu_get_num_rows(MenuLayer *menu_layer, uint16_t section_index, void *data) {
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "lists_menu_get_num_rows called");
+  DRAW_LOG("lists_menu_get_num_rows called");
   return task_lists_count;
 }
 
 static void lists_menu_draw_row(GContext* ctx, const Layer *cell_layer, MenuIndex *cell_index, void *data) {
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "lists_menu_draw_row called for row %d", cell_index->row);
+  DRAW_LOG("lists_menu_draw_row called for row %d", cell_index->row);
+  TRACE(TRACE_DRAW_ROW, cell_index->row);
   if (cell_index->row < task_lists_count) {
-    menu_cell_basic_draw(ctx, cell_layer, task_lists[cell_index->row].name, NULL, NULL);
+    menu_cell_basic_draw(ctx, cell_layer, task_list_get_name(&task_lists[cell_index->row]), NULL, NULL);
   }
+  TRACE(TRACE_DRAW_ROW_DONE, cell_index->row);
 }
 
 static void lists_menu_select(MenuLayer *menu_layer, MenuIndex *cell_index, void *data) {
@@ -73,23 +127,352 @@ static void lists_menu_select(MenuLayer *menu_layer, MenuIndex *cell_index, void
   selected_list_index = cell_index->row;
   current_state = STATE_TASKS;
 
-  // Free previous tasks and reset before fetching new list
-  if (tasks) { free(tasks); tasks = NULL; }
-  tasks_count = 0;
-  tasks_capacity = 0;
-  tasks_loading = true;
+  char id_buffer[UUID_STRING_SIZE];
+  const char *list_id = task_list_get_id(&task_lists[selected_list_index], id_buffer, sizeof(id_buffer));
+  if (strcmp(list_id, s_tasks_list_id) == 0 && tasks_count > 0) {
+    // Show the snapshot of this list at once; the fetch revalidates it in place
+    s_tasks_stale = true;
+    tasks_loading = false;
+  } else {
+    // Free previous tasks and reset before fetching new list
+    tasks_free();
+    s_tasks_stale = false;
+    s_tasks_version = 0;
+    tasks_loading = true;
+    snprintf(s_tasks_list_id, sizeof(s_tasks_list_id), "%s", list_id);
+  }
 
   window_stack_push(task_list_view_get_window(), true);
 
   #ifdef TESTING
     fetch_tasks_testing();
   #else
-    fetch_tasks(task_lists[selected_list_index].id);
+    fetch_tasks(s_tasks_list_id, s_tasks_version);
   #endif
   MenuLayer *tasks_menu = task_list_view_get_menu();
   if (tasks_menu) menu_layer_reload_data(tasks_menu);
 }
 
+#ifdef TRACE_ENABLED
+static void lists_menu_select_long(MenuLayer *menu_layer, MenuIndex *cell_index, void *data) {
+  trace_dump();
+}
+#endif
+
+// Record accessors
+
+static const char* record_id_to_string(const RecordId *id, uint8_t flags, const StringArena *arena,
+                                       char *buffer, size_t buffer_size) {
+  if (!(flags & RECORD_FLAG_UUID_ID)) {
+    return string_arena_get(arena, id->offset);
+  }
+
+  // Format as the canonical upper-case UUID the provider sent
+  static const char hex[] = "0123456789ABCDEF";
+  size_t pos = 0;
+  for (int i = 0; i < UUID_SIZE && pos + 3 < buffer_size; i++) {
+    if (i == 4 || i == 6 || i == 8 || i == 10) {
+      buffer[pos++] = '-';
+    }
+    buffer[pos++] = hex[id->uuid[i] >> 4];
+    buffer[pos++] = hex[id->uuid[i] & 0x0F];
+  }
+  buffer[pos] = '\0';
+  return buffer;
+}
+
+const char* task_list_get_name(const TaskList *list) {
+  return string_arena_get(&task_lists_arena, list->name);
+}
+
+const char* task_list_get_id(const TaskList *list, char *buffer, size_t buffer_size) {
+  return record_id_to_string(&list->id, list->flags, &task_lists_arena, buffer, buffer_size);
+}
+
+const char* task_get_name(const Task *task) {
+  return string_arena_get(&tasks_arena, task->name);
+}
+
+const char* task_get_id(const Task *task, char *buffer, size_t buffer_size) {
+  return record_id_to_string(&task->id, task->flags, &tasks_arena, buffer, buffer_size);
+}
+
+bool task_is_completed(const Task *task) {
+  return (task->flags & RECORD_FLAG_COMPLETED) != 0;
+}
+
+int task_get_priority(const Task *task) {
+  return (task->flags & RECORD_FLAG_PRIORITY_MASK) >> RECORD_FLAG_PRIORITY_SHIFT;
+}
+
+void task_set_completed(Task *task) {
+  task->flags |= RECORD_FLAG_COMPLETED;
+}
+
+void task_lists_free(void) {
+  if (task_lists) { free(task_lists); task_lists = NULL; }
+  string_arena_free(&task_lists_arena);
+  task_lists_count = 0;
+  task_lists_capacity = 0;
+}
+
+void tasks_free(void) {
+  if (tasks) { free(tasks); tasks = NULL; }
+  string_arena_free(&tasks_arena);
+  tasks_count = 0;
+  tasks_capacity = 0;
+  tasks_first = 0;
+}
+
+// Number of tasks[] slots that hold rows of the list
+static int tasks_resident(void) {
+  int resident = tasks_count - tasks_first;
+  return resident < tasks_capacity ? resident : tasks_capacity;
+}
+
+static bool tasks_paged(void) {
+  return tasks_count > tasks_capacity;
+}
+
+// Mark slots as not received yet
+static void clear_task_rows(Task *rows, int count) {
+  for (int i = 0; i < count; i++) {
+    memset(&rows[i], 0, sizeof(Task));
+    rows[i].name = STRING_ARENA_NONE;
+    rows[i].id.offset = STRING_ARENA_NONE;
+  }
+}
+
+Task* task_at(int row) {
+  int slot = row - tasks_first;
+  if (row >= tasks_count || slot < 0 || slot >= tasks_capacity || tasks[slot].name == STRING_ARENA_NONE) {
+    return NULL;
+  }
+  return &tasks[slot];
+}
+
+bool task_lists_alloc(int count, size_t arena_size) {
+  task_lists_free();
+  if (count <= 0) {
+    return true;
+  }
+  task_lists = (TaskList *)calloc(count, sizeof(TaskList));
+  if (task_lists && !string_arena_init(&task_lists_arena, arena_size)) {
+    free(task_lists);
+    task_lists = NULL;
+  }
+  task_lists_capacity = task_lists ? count : 0;
+  return task_lists != NULL;
+}
+
+bool tasks_alloc(int count, size_t arena_size) {
+  tasks_free();
+  if (count <= 0) {
+    return true;
+  }
+  tasks = (Task *)calloc(count, sizeof(Task));
+  if (tasks && !string_arena_init(&tasks_arena, arena_size)) {
+    free(tasks);
+    tasks = NULL;
+  }
+  tasks_capacity = tasks ? count : 0;
+  return tasks != NULL;
+}
+
+// Store a decoded id as binary UUID or as an arena string
+static bool store_record_id(RecordId *id, const Record *record, StringArena *arena) {
+  if (record->flags & RECORD_FLAG_UUID_ID) {
+    if (record->id_length != UUID_SIZE) {
+      return false;
+    }
+    memcpy(id->uuid, record->id, UUID_SIZE);
+    return true;
+  }
+  id->offset = string_arena_add(arena, record->id, record->id_length);
+  return id->offset != STRING_ARENA_NONE;
+}
+
+bool task_list_store_record(int index, const Record *record) {
+  TaskList *list = &task_lists[index];
+  list->flags = record->flags;
+  list->name = string_arena_add(&task_lists_arena, record->name, record->name_length);
+  return store_record_id(&list->id, record, &task_lists_arena) && list->name != STRING_ARENA_NONE;
+}
+
+bool task_store_record(int index, const Record *record) {
+  Task *task = &tasks[index];
+  task->flags = record->flags;
+  task->due_date = record->due_date;
+  format_friendly_date(task->due_date, task->flags & RECORD_FLAG_ALL_DAY, task->due_text, sizeof(task->due_text));
+  task->name = string_arena_add(&tasks_arena, record->name, record->name_length);
+  return store_record_id(&task->id, record, &tasks_arena) && task->name != STRING_ARENA_NONE;
+}
+
+// Point a record's id at the binary UUID or the arena string
+static void record_set_id(Record *record, const RecordId *id, uint8_t flags, const StringArena *arena) {
+  if (flags & RECORD_FLAG_UUID_ID) {
+    record->id = id->uuid;
+    record->id_length = UUID_SIZE;
+  } else {
+    const char *text = string_arena_get(arena, id->offset);
+    record->id = (const uint8_t *)text;
+    record->id_length = strlen(text);
+  }
+}
+
+void task_list_to_record(const TaskList *list, Record *record) {
+  const char *name = task_list_get_name(list);
+  record->flags = list->flags;
+  record->due_date = 0;
+  record_set_id(record, &list->id, list->flags, &task_lists_arena);
+  record->name = (const uint8_t *)name;
+  record->name_length = strlen(name);
+}
+
+void task_to_record(const Task *task, Record *record) {
+  const char *name = task_get_name(task);
+  record->flags = task->flags;
+  record->due_date = task->due_date;
+  record_set_id(record, &task->id, task->flags, &tasks_arena);
+  record->name = (const uint8_t *)name;
+  record->name_length = strlen(name);
+}
+
+// Resize a snapshot-filled array for an incoming stream. The stale rows stay
+// visible until the stream overwrites them; rows past the new count are dropped.
+static bool resize_records(void **records, size_t record_size, int *count, int *capacity, int new_count) {
+  void *resized = realloc(*records, new_count * record_size);
+  if (!resized) {
+    return false;
+  }
+  if (new_count > *capacity) {
+    memset((char *)resized + *capacity * record_size, 0, (new_count - *capacity) * record_size);
+  }
+  *records = resized;
+  *capacity = new_count;
+  if (*count > new_count) *count = new_count;
+  return true;
+}
+
+// Copy one string into a new arena, returning its new offset
+static uint16_t move_string(StringArena *to, const StringArena *from, uint16_t offset) {
+  if (offset == STRING_ARENA_NONE) {
+    return STRING_ARENA_NONE;
+  }
+  const char *text = string_arena_get(from, offset);
+  return string_arena_add(to, text, strlen(text));
+}
+
+// Strings of revalidated records are appended after the snapshot's; once the
+// stream completes, rebuild the arena from the live strings only
+static void task_lists_compact_arena(void) {
+  size_t size = 0;
+  for (int i = 0; i < task_lists_count; i++) {
+    size += strlen(task_list_get_name(&task_lists[i])) + 1;
+    if (!(task_lists[i].flags & RECORD_FLAG_UUID_ID)) {
+      size += strlen(string_arena_get(&task_lists_arena, task_lists[i].id.offset)) + 1;
+    }
+  }
+
+  StringArena compact;
+  if (size >= task_lists_arena.used || !string_arena_init(&compact, size)) {
+    return;
+  }
+  for (int i = 0; i < task_lists_count; i++) {
+    TaskList *list = &task_lists[i];
+    list->name = move_string(&compact, &task_lists_arena, list->name);
+    if (!(list->flags & RECORD_FLAG_UUID_ID)) {
+      list->id.offset = move_string(&compact, &task_lists_arena, list->id.offset);
+    }
+  }
+  string_arena_free(&task_lists_arena);
+  task_lists_arena = compact;
+}
+
+static void tasks_compact_arena(void) {
+  int resident = tasks_resident();
+  size_t size = 0;
+  for (int i = 0; i < resident; i++) {
+    size += strlen(task_get_name(&tasks[i])) + 1;
+    if (!(tasks[i].flags & RECORD_FLAG_UUID_ID)) {
+      size += strlen(string_arena_get(&tasks_arena, tasks[i].id.offset)) + 1;
+    }
+  }
+
+  StringArena compact;
+  if (size >= tasks_arena.used || !string_arena_init(&compact, size)) {
+    return;
+  }
+  for (int i = 0; i < resident; i++) {
+    Task *task = &tasks[i];
+    task->name = move_string(&compact, &tasks_arena, task->name);
+    if (!(task->flags & RECORD_FLAG_UUID_ID)) {
+      task->id.offset = move_string(&compact, &tasks_arena, task->id.offset);
+    }
+  }
+  string_arena_free(&tasks_arena);
+  tasks_arena = compact;
+}
+
+// Move the window of a paged list to start at row first, keeping the rows
+// both windows share and evicting the rest
+static void tasks_shift_window(int first) {
+  int shift = first - tasks_first;
+  int kept = tasks_capacity - (shift < 0 ? -shift : shift);
+  if (kept <= 0) {
+    clear_task_rows(tasks, tasks_capacity);
+  } else if (shift > 0) {
+    memmove(tasks, &tasks[shift], kept * sizeof(Task));
+    clear_task_rows(&tasks[kept], shift);
+  } else {
+    memmove(&tasks[-shift], tasks, kept * sizeof(Task));
+    clear_task_rows(tasks, -shift);
+  }
+  tasks_first = first;
+  tasks_compact_arena();
+}
+
+void tasks_ensure_loaded(int row) {
+  if (!tasks_paged()) {
+    return;
+  }
+
+  // Centre the window on the row's page, within the list
+  int pages = (tasks_count + TASKS_PAGE_ROWS - 1) / TASKS_PAGE_ROWS;
+  int first_page = row / TASKS_PAGE_ROWS - TASKS_WINDOW_PAGES / 2;
+  if (first_page > pages - TASKS_WINDOW_PAGES) first_page = pages - TASKS_WINDOW_PAGES;
+  if (first_page < 0) first_page = 0;
+  if (first_page * TASKS_PAGE_ROWS != tasks_first) {
+    tasks_shift_window(first_page * TASKS_PAGE_ROWS);
+  }
+
+  // Ask for the rows of the window that have not arrived
+  int first = -1;
+  int last = -1;
+  int missing = 0;
+  int resident = tasks_resident();
+  for (int i = 0; i < resident; i++) {
+    if (tasks[i].name == STRING_ARENA_NONE) {
+      if (first < 0) first = i;
+      last = i;
+      missing++;
+    }
+  }
+  if (first < 0) {
+    return;
+  }
+  first += tasks_first;
+  int count = last + tasks_first - first + 1;
+  if (first >= s_page_request_first && first + count <= s_page_request_first + s_page_request_count) {
+    return;
+  }
+  s_page_request_first = first;
+  s_page_request_count = count;
+  s_tasks_pending = missing;
+  bulk_transfer_begin(2, missing);
+  fetch_task_page(s_tasks_list_id, first, count);
+}
+
 time_t convert_iso_to_time_t(const char* iso_date_str) {
     if (!iso_date_str || strlen(iso_date_str) == 0) {
         return (time_t)-1;
@@ -176,24 +559,54 @@ void convert_iso_to_friendly_date(const char* iso_date_str, char* buffer, size_t
     return;
   }
 
-  APP_LOG(APP_LOG_LEVEL_INFO, "convert_iso_to_friendly_date - timestamp: %ld", (long)timestamp);
+  format_friendly_date(timestamp, false, buffer, buffer_size);
+}
+
+void format_friendly_date(time_t due_date, bool all_day, char* buffer, size_t buffer_size) {
+  if (due_date == 0) {
+    snprintf(buffer, buffer_size, STR_NO_DUE_DATE);
+    return;
+  }
 
-  struct tm *local_time = localtime(&timestamp);
+  struct tm *local_time = localtime(&due_date);
+  time_t today = time_start_of_today();
+  char time_text[12] = "";
 
-  APP_LOG(APP_LOG_LEVEL_INFO, "convert_iso_to_friendly_date - localtime hour: %d, min: %d",
-          local_time->tm_hour, local_time->tm_min);
+  // Format the time based on user preference: "14:30" or "02:30 PM";
+  // an all-day date shows the day alone
+  if (!all_day) {
+    strftime(time_text, sizeof(time_text), clock_is_24h_style() ? " %H:%M" : " %I:%M %p", local_time);
+  }
 
-  // Format the time and date based on user preference
-  if (clock_is_24h_style()) {
-    // 24-hour format: "Mon Feb 15 14:30"
-    strftime(buffer, buffer_size, "%a %b %d %H:%M", local_time);
+  if (due_date >= today && due_date < today + SECONDS_PER_DAY) {
+    snprintf(buffer, buffer_size, "%s%s", STR_TODAY, time_text);
+  } else if (due_date >= today + SECONDS_PER_DAY && due_date < today + 2 * SECONDS_PER_DAY) {
+    snprintf(buffer, buffer_size, "%s%s", STR_TOMORROW, time_text);
   } else {
-    // 12-hour format with AM/PM: "Mon Feb 15 2:30 PM"
-    strftime(buffer, buffer_size, "%a %b %d %I:%M %p", local_time);
+    // "Mon Feb 15 14:30" or "Mon Feb 15 02:30 PM"
+    char date_text[12];
+    strftime(date_text, sizeof(date_text), "%a %b %d", local_time);
+    snprintf(buffer, buffer_size, "%s%s", date_text, time_text);
   }
+}
 
-  APP_LOG(APP_LOG_LEVEL_INFO, "convert_iso_to_friendly_date - Output: %s", buffer);
+// Re-render every task's due text; needed when the day or clock style changes
+void tasks_refresh_due_texts(void) {
+  s_clock_24h = clock_is_24h_style();
+  int resident = tasks_resident();
+  for (int i = 0; i < resident; i++) {
+    format_friendly_date(tasks[i].due_date, tasks[i].flags & RECORD_FLAG_ALL_DAY,
+                         tasks[i].due_text, sizeof(tasks[i].due_text));
+  }
+}
 
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  // "Today"/"Tomorrow" move at midnight; the time format follows the clock setting
+  if ((units_changed & DAY_UNIT) || clock_is_24h_style() != s_clock_24h) {
+    tasks_refresh_due_texts();
+    MenuLayer *tasks_menu = task_list_view_get_menu();
+    if (tasks_menu) menu_layer_reload_data(tasks_menu);
+  }
 }
 
 // AppMessage handlers
@@ -218,6 +631,172 @@ static const char* app_message_result_to_string(AppMessageResult result) {
   }
 }
 
+// Unpack all records of a batched frame in a single pass over the dictionary.
+// Returns the number of records stored.
+static int receive_batch(DictionaryIterator *iterator, int type) {
+  Tuple *batch_tuple = dict_find(iterator, KEY_BATCH);
+  if (!batch_tuple || batch_tuple->value->int32 <= 0) {
+    return 0;
+  }
+  Tuple *idx_tuple = dict_find(iterator, KEY_IDX);
+  int *received = type == 1 ? &s_lists_received : &s_tasks_received;
+  int first = idx_tuple ? idx_tuple->value->int32 : *received;
+  int capacity = type == 1 ? task_lists_capacity : tasks_capacity;
+  int offset = type == 1 ? 0 : tasks_first;  // row held in slot 0 of a paged list
+  int *count = type == 1 ? &task_lists_count : &tasks_count;
+  int stored = 0;
+
+  for (Tuple *t = dict_read_first(iterator); t; t = dict_read_next(iterator)) {
+    if (t->key < KEY_RECORD_BASE || t->type != TUPLE_BYTE_ARRAY) continue;
+    int n = t->key - KEY_RECORD_BASE;
+    int i = first + n;
+    int slot = i - offset;
+    if (n >= MAX_BATCH_RECORDS || slot < 0 || slot >= capacity) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Record %d out of range", i);
+      continue;
+    }
+
+    Record record;
+    if (!record_decode(t->value->data, t->length, &record)) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Malformed record %d", i);
+      continue;
+    }
+
+    // A paged list only waits for rows it has not got; a page may resend rows
+    // an earlier page already filled
+    bool awaited = type == 2 && (!tasks_paged() || tasks[slot].name == STRING_ARENA_NONE);
+    bool ok = type == 1 ? task_list_store_record(slot, &record) : task_store_record(slot, &record);
+    if (!ok) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Out of memory storing record %d", i);
+      continue;
+    }
+
+    if (i >= *count) *count = i + 1;
+    if (i >= *received) *received = i + 1;
+    if (awaited && s_tasks_pending > 0) s_tasks_pending--;
+    stored++;
+  }
+
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "received %d records of type %d starting at %d", stored, type, first);
+  TRACE(TRACE_PARSED, stored);
+  return stored;
+}
+
+static MenuLayer* lists_menu_get(void) {
+  return s_lists_menu;
+}
+
+// Reload a menu after a batch arrived. Batches are coalesced into at most one
+// reload per MENU_REDRAW_INTERVAL_MS, except that the reload happens at once
+// when the first screenful is complete or the stream has finished.
+static void schedule_batch_redraw(MenuGetter getter, int previous_received, int received, bool complete) {
+  menu_redraw_schedule(getter);
+  if (complete || (previous_received < FIRST_SCREEN_ROWS && received >= FIRST_SCREEN_ROWS)) {
+    menu_redraw_flush();
+  }
+}
+
+static uint16_t read_uint16(const uint8_t *data) {
+  return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+// Rebuild tasks[] from a delta layout (see LAYOUT_NEW_ROWS in task_manager.h).
+// Kept rows are copied with their strings; new rows stay empty until their
+// records arrive. Returns the number of new rows, or -1 if the layout does
+// not fit the tasks held.
+static int apply_tasks_layout(const uint8_t *layout, uint16_t length, int count) {
+  Task *updated = (Task *)calloc(count, sizeof(Task));
+  if (!updated) {
+    return -1;
+  }
+
+  int row = 0;
+  int pending = 0;
+  for (uint16_t pos = 0; pos + 4 <= length; pos += 4) {
+    int from = read_uint16(&layout[pos]);
+    int run = read_uint16(&layout[pos + 2]);
+    if (row + run > count || (from != LAYOUT_NEW_ROWS && from + run > tasks_count)) {
+      break;
+    }
+    if (from == LAYOUT_NEW_ROWS) {
+      for (int i = row; i < row + run; i++) {
+        updated[i].name = STRING_ARENA_NONE;
+        updated[i].id.offset = STRING_ARENA_NONE;
+      }
+      pending += run;
+    } else {
+      memcpy(&updated[row], &tasks[from], run * sizeof(Task));
+    }
+    row += run;
+  }
+
+  if (row != count) {
+    free(updated);
+    return -1;
+  }
+
+  free(tasks);
+  tasks = updated;
+  tasks_count = count;
+  tasks_capacity = count;
+  tasks_first = 0;
+  return pending;
+}
+
+// All rows of the tasks stream have arrived: drop replaced strings, take the
+// streamed version and persist the result if anything changed. A paged list
+// is never complete on the watch, so it gets no version and no snapshot.
+static void finish_tasks_stream(bool changed) {
+  tasks_compact_arena();
+  s_tasks_stale = false;
+  if (tasks_paged()) {
+    s_tasks_version = 0;
+    return;
+  }
+  s_tasks_version = s_tasks_stream_version;
+  if (changed) {
+    snapshot_save_tasks(s_tasks_list_id, s_tasks_version);
+  }
+}
+
+// The server is done with a streamed list: shrink a short one to its rows,
+// then wait for the rows of the window still missing
+static void finish_streamed_tasks(uint32_t version) {
+  s_tasks_streaming = false;
+  s_tasks_stream_version = version;
+  if (tasks_count > 0 && tasks_count < tasks_capacity) {
+    resize_records((void **)&tasks, sizeof(Task), &tasks_count, &tasks_capacity, tasks_count);
+  }
+
+  s_tasks_pending = 0;
+  int resident = tasks_resident();
+  for (int i = 0; i < resident; i++) {
+    if (tasks[i].name == STRING_ARENA_NONE) s_tasks_pending++;
+  }
+  if (s_tasks_pending == 0) {
+    tasks_loading = false;
+    finish_tasks_stream(true);
+    bulk_transfer_end(2);
+    menu_redraw_flush();
+  }
+}
+
+// Drop messages of a superseded stream, asking the phone once to stop it
+static bool stream_is_current(DictionaryIterator *iterator, uint32_t generation) {
+  Tuple *generation_tuple = dict_find(iterator, KEY_GENERATION);
+  if (!generation_tuple || generation_tuple->value->uint32 == generation) {
+    return true;
+  }
+
+  uint32_t stale = generation_tuple->value->uint32;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Dropping message of stale stream %lu", (unsigned long)stale);
+  if (stale != s_cancelled_generation) {
+    s_cancelled_generation = stale;
+    cancel_stream(stale);
+  }
+  return false;
+}
+
 static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
   APP_LOG(APP_LOG_LEVEL_DEBUG, "inbox_received_callback called");
   
@@ -225,9 +804,14 @@ static void inbox_received_callback(DictionaryIterator *iterator, void *context)
   
   if (type_tuple) {
     int type = type_tuple->value->int32;
+    TRACE(TRACE_INBOX, type);
 
     switch(type) {
       case 0: { // JS ready signal
+        if (js_ready) {
+          // A resent ready whose first ACK was lost
+          break;
+        }
         APP_LOG(APP_LOG_LEVEL_INFO, "JavaScript is ready!");
         js_ready = true;
         // Now fetch task lists if we're on the lists window
@@ -238,103 +822,154 @@ static void inbox_received_callback(DictionaryIterator *iterator, void *context)
       }
       case 1: { // Task list names
         APP_LOG(APP_LOG_LEVEL_DEBUG, "inbox, received list data");
+        if (!stream_is_current(iterator, s_lists_generation)) {
+          break;
+        }
 
         Tuple *count_tuple = dict_find(iterator, KEY_COUNT);
         if (count_tuple) {
           // Count message — allocate array
           int count = count_tuple->value->int32;
-          APP_LOG(APP_LOG_LEVEL_INFO, "Allocating task_lists for %d lists", count);
-          if (task_lists) free(task_lists);
-          task_lists_count = 0;
-          if (count > 0) {
-            task_lists = (TaskList *)malloc(count * sizeof(TaskList));
-            task_lists_capacity = task_lists ? count : 0;
-          } else {
-            task_lists = NULL;
-            task_lists_capacity = 0;
+          Tuple *arena_tuple = dict_find(iterator, KEY_ARENA_SIZE);
+          int arena_size = arena_tuple ? arena_tuple->value->int32 : 0;
+          APP_LOG(APP_LOG_LEVEL_INFO, "Allocating task_lists for %d lists, %d string bytes", count, arena_size);
+          s_lists_received = 0;
+          if (!(s_lists_stale && count > 0 &&
+                resize_records((void **)&task_lists, sizeof(TaskList), &task_lists_count, &task_lists_capacity, count))) {
+            // Nothing to revalidate in place; start over
+            s_lists_stale = false;
+            task_lists_alloc(count, arena_size);
           }
-          if (s_lists_menu) menu_layer_reload_data(s_lists_menu);
+          bulk_transfer_begin(1, count);
+          menu_redraw_schedule(lists_menu_get);
+          menu_redraw_flush();
+          if (count == 0) snapshot_save_lists();
           break;
         }
 
-        Tuple *id_tuple = dict_find(iterator, KEY_ID);
-        Tuple *name_tuple = dict_find(iterator, KEY_NAME);
-        if (name_tuple && task_lists && task_lists_count < task_lists_capacity) {
-          snprintf(task_lists[task_lists_count].id, sizeof(task_lists[0].id),
-                   "%s", id_tuple->value->cstring);
-          snprintf(task_lists[task_lists_count].name, sizeof(task_lists[0].name),
-                   "%s", name_tuple->value->cstring);
-          APP_LOG(APP_LOG_LEVEL_DEBUG, "added list name: %s", task_lists[task_lists_count].name);
-          task_lists_count++;
-          if (s_lists_menu) menu_layer_reload_data(s_lists_menu);
+        int previous_received = s_lists_received;
+        receive_batch(iterator, 1);
+        bulk_transfer_progress(1);
+        if (s_lists_received >= task_lists_capacity) {
+          if (s_lists_stale) task_lists_compact_arena();
+          s_lists_stale = false;
+          snapshot_save_lists();
+          bulk_transfer_end(1);
         }
+        schedule_batch_redraw(lists_menu_get, previous_received, s_lists_received,
+                              s_lists_received >= task_lists_capacity);
         break;
       }
       
       case 2: { // Tasks in a list
         APP_LOG(APP_LOG_LEVEL_DEBUG, "inbox, received task data");
-
-        // Clear loading flag when receiving any task message
-        if (tasks_loading) {
-          tasks_loading = false;
+        if (!stream_is_current(iterator, s_tasks_generation)) {
+          break;
         }
 
+        Tuple *total_tuple = dict_find(iterator, KEY_TOTAL);
         Tuple *count_tuple = dict_find(iterator, KEY_COUNT);
+        if (total_tuple && !count_tuple) {
+          // Length of a list being streamed: the rows known so far, or with a
+          // version, the final length
+          if (!s_tasks_streaming) {
+            break;
+          }
+          if (total_tuple->value->int32 >= tasks_count) {
+            tasks_count = total_tuple->value->int32;
+            menu_redraw_schedule(task_list_view_get_menu);
+          }
+          Tuple *version_tuple = dict_find(iterator, KEY_VERSION);
+          if (version_tuple) {
+            APP_LOG(APP_LOG_LEVEL_INFO, "Streamed list has %d tasks", tasks_count);
+            finish_streamed_tasks(version_tuple->value->uint32);
+          }
+          break;
+        }
+
         if (count_tuple) {
-          // Count message — allocate array
+          // Count message — allocate array, or patch the tasks held when it carries a layout
           int count = count_tuple->value->int32;
-          APP_LOG(APP_LOG_LEVEL_INFO, "Allocating tasks for %d tasks", count);
-          if (tasks) free(tasks);
-          tasks_count = 0;
-          if (count > 0) {
-            tasks = (Task *)malloc(count * sizeof(Task));
-            tasks_capacity = tasks ? count : 0;
+          Tuple *arena_tuple = dict_find(iterator, KEY_ARENA_SIZE);
+          int arena_size = arena_tuple ? arena_tuple->value->int32 : 0;
+          Tuple *version_tuple = dict_find(iterator, KEY_VERSION);
+          Tuple *layout_tuple = dict_find(iterator, KEY_LAYOUT);
+          uint32_t held_version = s_tasks_version;
+          s_tasks_stream_version = version_tuple ? version_tuple->value->uint32 : 0;
+          s_tasks_received = 0;
+          s_tasks_streaming = total_tuple != NULL;
+
+          if (layout_tuple && layout_tuple->type == TUPLE_BYTE_ARRAY) {
+            APP_LOG(APP_LOG_LEVEL_INFO, "Patching tasks to %d rows, version %lu",
+                    count, (unsigned long)s_tasks_stream_version);
+            s_tasks_pending = apply_tasks_layout(layout_tuple->value->data, layout_tuple->length, count);
+            if (s_tasks_pending < 0) {
+              // Our rows do not match what the phone diffed against; ask for everything
+              APP_LOG(APP_LOG_LEVEL_ERROR, "Delta does not apply, refetching list");
+              tasks_free();
+              s_tasks_version = 0;
+              tasks_loading = true;
+              fetch_tasks(s_tasks_list_id, 0);
+              break;
+            }
+            s_tasks_stale = false;
+          } else if (count > TASKS_WINDOW_ROWS || s_tasks_streaming) {
+            // Too long to hold, or of unknown length: the rows of the first
+            // window follow, the rest is paged in on scroll
+            APP_LOG(APP_LOG_LEVEL_INFO, "Paging %d tasks, %d string bytes", count, arena_size);
+            s_tasks_stale = false;
+            if (tasks_alloc(TASKS_WINDOW_ROWS, arena_size)) {
+              clear_task_rows(tasks, tasks_capacity);
+              tasks_count = count;
+            }
+            s_tasks_pending = tasks_capacity;
+            s_page_request_first = 0;
+            s_page_request_count = tasks_capacity;
           } else {
-            tasks = NULL;
-            tasks_capacity = 0;
-            // Reload menu to show "No tasks" instead of "Loading..."
-            MenuLayer *tasks_menu = task_list_view_get_menu();
-            if (tasks_menu) menu_layer_reload_data(tasks_menu);
+            APP_LOG(APP_LOG_LEVEL_INFO, "Allocating tasks for %d tasks, %d string bytes", count, arena_size);
+            s_tasks_pending = count;
+            if (!(s_tasks_stale && count > 0 &&
+                  resize_records((void **)&tasks, sizeof(Task), &tasks_count, &tasks_capacity, count))) {
+              // Nothing to revalidate in place; start over
+              s_tasks_stale = false;
+              tasks_alloc(count, arena_size);
+            }
+          }
+          s_tasks_version = 0;
+          bulk_transfer_begin(2, s_tasks_pending);
+
+          if (s_tasks_pending == 0) {
+            // Empty or unchanged list; reload menu to show the rows instead of "Loading..."
+            tasks_loading = false;
+            finish_tasks_stream(!layout_tuple || s_tasks_stream_version != held_version);
+            menu_redraw_schedule(task_list_view_get_menu);
+            menu_redraw_flush();
           }
           break;
         }
 
-        // Parse task data from dictionary
-        Tuple *id_tuple = dict_find(iterator, KEY_ID);
-        Tuple *name_tuple = dict_find(iterator, KEY_NAME);
-        Tuple *due_tuple = dict_find(iterator, KEY_DUE_DATE);
-        Tuple *completed_tuple = dict_find(iterator, KEY_COMPLETED);
-        Tuple *idx_tuple = dict_find(iterator, KEY_IDX);
-        Tuple *priority_tuple = dict_find(iterator, KEY_PRIORITY);
-
-        // Check if this is an empty task message (used to signal end of empty list)
-        if (name_tuple && strlen(name_tuple->value->cstring) == 0) {
-          APP_LOG(APP_LOG_LEVEL_DEBUG, "Received empty task list message");
-          MenuLayer *tasks_menu = task_list_view_get_menu();
-          if (tasks_menu) menu_layer_reload_data(tasks_menu);
-          break;
+        int previous_received = s_tasks_received;
+        int previous_pending = s_tasks_pending;
+        receive_batch(iterator, 2);
+        bulk_transfer_progress(2);
+        tasks_loading = false;
+        // The rows of the stream, or of the page requested last, are all in;
+        // a stream of unknown length ends with its final length
+        bool complete = previous_pending > 0 && s_tasks_pending == 0 && !s_tasks_streaming;
+        if (complete) {
+          finish_tasks_stream(true);
+          bulk_transfer_end(2);
         }
+        schedule_batch_redraw(task_list_view_get_menu, previous_received, s_tasks_received, complete);
+        break;
+      }
 
-        if (id_tuple && name_tuple && tasks && tasks_count < tasks_capacity) {
-          APP_LOG(APP_LOG_LEVEL_DEBUG, "inbox, setting task data");
-
-          snprintf(tasks[tasks_count].id, sizeof(tasks[0].id),
-                   "%s", id_tuple->value->cstring);
-          snprintf(tasks[tasks_count].name, sizeof(tasks[0].name),
-                   "%s", name_tuple->value->cstring);
-          if (due_tuple) {
-            snprintf(tasks[tasks_count].due_date, sizeof(tasks[0].due_date),
-                     "%s", due_tuple->value->cstring);
-          }
-          tasks[tasks_count].completed = completed_tuple ? completed_tuple->value->int16 : 0;
-          tasks[tasks_count].priority = priority_tuple ? priority_tuple->value->int16 : 0;
-          tasks[tasks_count].idx = idx_tuple ? idx_tuple->value->int16 : 0;
-
-          tasks_count++;
-          MenuLayer *tasks_menu = task_list_view_get_menu();
-          if (tasks_menu) menu_layer_reload_data(tasks_menu);
-        } else {
-          APP_LOG(APP_LOG_LEVEL_ERROR, "Missing task data or task limit reached");
+      case 5: { // Notes for one task
+        Tuple *id_tuple = dict_find(iterator, KEY_ID);
+        Tuple *notes_tuple = dict_find(iterator, KEY_NOTES);
+        if (id_tuple) {
+          notes_cache_put(id_tuple->value->cstring, notes_tuple ? notes_tuple->value->cstring : "");
+          task_detail_view_notes_received(id_tuple->value->cstring);
         }
         break;
       }
@@ -349,11 +984,12 @@ static void inbox_dropped_callback(AppMessageResult reason, void *context) {
 static void outbox_failed_callback(DictionaryIterator *iterator, AppMessageResult reason, void *context) {
   APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed!");
   APP_LOG(APP_LOG_LEVEL_ERROR, "Error sending outbox: %s", app_message_result_to_string(reason));
-
+  request_queue_handle_failed(reason);
 }
 
 static void outbox_sent_callback(DictionaryIterator *iterator, void *context) {
   APP_LOG(APP_LOG_LEVEL_INFO, "Outbox send success!");
+  request_queue_handle_sent();
 }
 
 // API functions
@@ -362,13 +998,14 @@ static void fetch_task_lists_testing(void) {
   APP_LOG(APP_LOG_LEVEL_DEBUG, "fetch_task_lists_testing called");
 
   int n = (int)(sizeof(task_lists_testing) / sizeof(task_lists_testing[0]));
-  if (task_lists) free(task_lists);
-  task_lists = (TaskList *)malloc(n * sizeof(TaskList));
+  task_lists_free();
+  task_lists = (TaskList *)calloc(n, sizeof(TaskList));
   task_lists_capacity = task_lists ? n : 0;
-  task_lists_count = 0;
   for (int i = 0; i < n && task_lists_count < task_lists_capacity; i++) {
-    snprintf(task_lists[task_lists_count].name, sizeof(task_lists[task_lists_count].name), "%s", task_lists_testing[i]);
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "added list name: %s", task_lists[task_lists_count].name);
+    TaskList *list = &task_lists[task_lists_count];
+    list->name = string_arena_add(&task_lists_arena, task_lists_testing[i], strlen(task_lists_testing[i]));
+    list->id.offset = list->name;
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "added list name: %s", task_list_get_name(list));
     task_lists_count++;
   }
   if (s_lists_menu) menu_layer_reload_data(s_lists_menu);
@@ -433,88 +1070,112 @@ static void fetch_tasks_testing(void) {
 
   // Sample due dates
   const char* sample_dates[] = {
-    "2026-02-01", "2026-02-05", "2026-02-10", "2026-02-15", "2026-02-20",
-    "2026-03-01", "2026-03-05", "2026-03-10", "2026-03-15", "2026-03-20"
+    "2026-02-01T09:00:00", "2026-02-05T09:00:00", "2026-02-10T09:00:00", "2026-02-15T09:00:00", "2026-02-20T09:00:00",
+    "2026-03-01T09:00:00", "2026-03-05T09:00:00", "2026-03-10T09:00:00", "2026-03-15T09:00:00", "2026-03-20T09:00:00"
   };
 
   int test_count = 10;
-  if (tasks) free(tasks);
-  tasks = (Task *)malloc(test_count * sizeof(Task));
+  tasks_free();
+  tasks = (Task *)calloc(test_count, sizeof(Task));
   tasks_capacity = tasks ? test_count : 0;
-  tasks_count = test_count;
+  tasks_count = tasks_capacity;
   for (int i = 0; i < tasks_count; i++) {
-    // Cycle through list indices
-    tasks[i].idx = i % 14;
+    char id[16];
     
     // Generate unique ID
-    snprintf(tasks[i].id, sizeof(tasks[i].id), "task_%d", i);
+    snprintf(id, sizeof(id), "task_%d", i);
+    tasks[i].id.offset = string_arena_add(&tasks_arena, id, strlen(id));
     
     // Assign sample name
-    snprintf(tasks[i].name, sizeof(tasks[i].name), "%s", sample_names[i % 50]);
+    tasks[i].name = string_arena_add(&tasks_arena, sample_names[i % 50], strlen(sample_names[i % 50]));
     
     // Assign priority (0-3)
-    tasks[i].priority = i % 4;
+    tasks[i].flags = (i % 4) << RECORD_FLAG_PRIORITY_SHIFT;
     
     // Assign due date
-    snprintf(tasks[i].due_date, sizeof(tasks[i].due_date), "%s", sample_dates[i % 10]);
+    tasks[i].due_date = convert_iso_to_time_t(sample_dates[i % 10]);
+    format_friendly_date(tasks[i].due_date, false, tasks[i].due_text, sizeof(tasks[i].due_text));
     
     // Roughly 30% completed
-    tasks[i].completed = (i % 10 < 3) ? true : false;
+    if (i % 10 < 3) task_set_completed(&tasks[i]);
     
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "added task: %s (list idx: %d)", tasks[i].name, tasks[i].idx);
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "added task: %s", task_get_name(&tasks[i]));
   }
   
-  if (s_tasks_menu) menu_layer_reload_data(s_tasks_menu);
+  MenuLayer *tasks_menu = task_list_view_get_menu();
+  if (tasks_menu) menu_layer_reload_data(tasks_menu);
 }
 #endif
 
 void fetch_task_lists(void) {
   APP_LOG(APP_LOG_LEVEL_DEBUG, "fetch_task_lists called");
 
-  DictionaryIterator *iter;
-  AppMessageResult result = app_message_outbox_begin(&iter);
-  if (result != APP_MSG_OK) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Error beginning outbox: %s", app_message_result_to_string(result));
-    return;
-  }
+  // Only the newest list refresh matters
+  request_queue_cancel(1);
+  s_lists_generation = ++s_generation;
+  RequestField fields[] = {
+    REQUEST_UINT(KEY_INBOX_SIZE, s_inbox_size),
+    REQUEST_UINT(KEY_GENERATION, s_lists_generation),
+  };
+  request_queue_send(1, REQUEST_PRIORITY_LISTS, fields, ARRAY_LENGTH(fields));
+}
 
-  // Send a test message with more data to verify format
-  APP_LOG(APP_LOG_LEVEL_ERROR, "Sending KEY_TYPE = 1");
-  dict_write_uint8(iter, KEY_TYPE, 1);
+void fetch_tasks(const char *list_id, uint32_t version) {
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "fetch_tasks called for list: %s, version %lu", list_id, (unsigned long)version);
+
+  // A newer list selection replaces a pending one, and its pages
+  request_queue_cancel(2);
+  request_queue_cancel(6);
+  s_tasks_generation = ++s_generation;
+  RequestField fields[] = {
+    REQUEST_CSTRING(KEY_ID, list_id),
+    REQUEST_UINT(KEY_VERSION, version),
+    REQUEST_UINT(KEY_COUNT, TASKS_WINDOW_ROWS),
+    REQUEST_UINT(KEY_INBOX_SIZE, s_inbox_size),
+    REQUEST_UINT(KEY_GENERATION, s_tasks_generation),
+  };
+  request_queue_send(2, REQUEST_PRIORITY_TASKS, fields, ARRAY_LENGTH(fields));
+}
 
-  result = app_message_outbox_send();
-  if (result != APP_MSG_OK) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Error sending outbox: %s", app_message_result_to_string(result));
-  } else {
-    APP_LOG(APP_LOG_LEVEL_INFO, "Message sent successfully");
+void complete_task(const char *task_id, const char *list_name) {
+  RequestField fields[] = {
+    REQUEST_CSTRING(KEY_ID, task_id),
+    REQUEST_CSTRING(KEY_LIST_NAME, list_name),
+  };
+  if (!request_queue_send(3, REQUEST_PRIORITY_COMPLETE, fields, ARRAY_LENGTH(fields))) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not queue completion of %s", task_id);
   }
 }
 
-void fetch_tasks(const char *list_id) {
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "fetch_tasks called for list: %s", list_id);
+void fetch_task_notes(const char *list_id, const char *task_id) {
+  // Only the task on screen needs its notes
+  request_queue_cancel(5);
+  RequestField fields[] = {
+    REQUEST_CSTRING(KEY_ID, task_id),
+    REQUEST_CSTRING(KEY_LIST_ID, list_id),
+  };
+  request_queue_send(5, REQUEST_PRIORITY_TASKS, fields, ARRAY_LENGTH(fields));
+}
 
-  DictionaryIterator *iter;
-  AppMessageResult result = app_message_outbox_begin(&iter);
-  if (result != APP_MSG_OK) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "app_message_outbox_begin failed: %s", app_message_result_to_string(result));
-    return;
+void fetch_task_page(const char *list_id, int first, int count) {
+  // The window has moved on from any page still waiting
+  request_queue_cancel(6);
+  RequestField fields[] = {
+    REQUEST_CSTRING(KEY_ID, list_id),
+    REQUEST_UINT(KEY_IDX, first),
+    REQUEST_UINT(KEY_COUNT, count),
+    REQUEST_UINT(KEY_GENERATION, s_tasks_generation),
+  };
+  if (!request_queue_send(6, REQUEST_PRIORITY_TASKS, fields, ARRAY_LENGTH(fields))) {
+    s_page_request_count = 0;  // retry on the next scroll
   }
-  dict_write_uint8(iter, KEY_TYPE, 2); // Request tasks
-  dict_write_cstring(iter, KEY_ID, list_id);
-  app_message_outbox_send();
 }
 
-void complete_task(const char *task_id, const char *list_name) {
-  DictionaryIterator *iter;
-  AppMessageResult result = app_message_outbox_begin(&iter);
-  if (result != APP_MSG_OK) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "app_message_outbox_begin failed: %s", app_message_result_to_string(result));
-    return;
-  }
-  dict_write_uint8(iter, KEY_TYPE, 3); // Complete task
-  dict_write_cstring(iter, KEY_ID, task_id);
-  dict_write_cstring(iter, KEY_LIST_NAME, list_name);
-  app_message_outbox_send();
+void cancel_stream(uint32_t generation) {
+  RequestField fields[] = {
+    REQUEST_UINT(KEY_GENERATION, generation),
+  };
+  request_queue_send(7, REQUEST_PRIORITY_CANCEL, fields, ARRAY_LENGTH(fields));
 }
 
 // Main window
@@ -536,13 +1197,13 @@ static void lists_window_load(Window *window) {
     .get_num_rows = lists_menu_get_num_rows,
     .draw_row = lists_menu_draw_row,
     .select_click = lists_menu_select,
+#ifdef TRACE_ENABLED
+    .select_long_click = lists_menu_select_long,
+#endif
   });
   menu_layer_set_click_config_onto_window(s_lists_menu, window);
   layer_add_child(window_layer, menu_layer_get_layer(s_lists_menu));
 
-  // Reset count before fetching task lists
-  task_lists_count = 0;
-
   // Fetch initial data now that menu is ready
 #ifdef TESTING
   fetch_task_lists_testing();
@@ -567,6 +1228,14 @@ static void lists_window_unload(Window *window) {
   }
 }
 
+static uint32_t choose_inbox_size(void) {
+  uint32_t size = heap_bytes_free() / APP_MESSAGE_HEAP_SHARE;
+  if (size > APP_MESSAGE_INBOX_CAP) size = APP_MESSAGE_INBOX_CAP;
+  if (size > app_message_inbox_size_maximum()) size = app_message_inbox_size_maximum();
+  if (size < APP_MESSAGE_INBOX_MIN) size = APP_MESSAGE_INBOX_MIN;
+  return size;
+}
+
 static void init(void) {
   // Register callbacks
   app_message_register_inbox_received(inbox_received_callback);
@@ -574,9 +1243,20 @@ static void init(void) {
   app_message_register_outbox_failed(outbox_failed_callback);
   app_message_register_outbox_sent(outbox_sent_callback);
   
-  // Open AppMessage
-  //app_message_open(app_message_inbox_size_maximum(), app_message_outbox_size_maximum());
-  app_message_open(512, 512);
+  // Render the last session's lists and tasks at once; they are revalidated
+  // in place when the phone answers
+  s_lists_stale = snapshot_load_lists();
+  s_tasks_stale = snapshot_load_tasks(s_tasks_list_id, sizeof(s_tasks_list_id), &s_tasks_version);
+
+  // Open AppMessage, sized from what is left of the heap
+  s_inbox_size = choose_inbox_size();
+  APP_LOG(APP_LOG_LEVEL_INFO, "AppMessage inbox %lu bytes, %d bytes heap free",
+          (unsigned long)s_inbox_size, (int)heap_bytes_free());
+  app_message_open(s_inbox_size, APP_MESSAGE_OUTBOX_SIZE);
+
+  // Keep pre-rendered due dates current without formatting on the draw path
+  s_clock_24h = clock_is_24h_style();
+  tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
   
   // Create lists (main) Window
   s_lists_window = window_create();
@@ -595,8 +1275,12 @@ static void init(void) {
 }
 
 static void deinit(void) {
-  if (task_lists) { free(task_lists); task_lists = NULL; }
-  if (tasks) { free(tasks); tasks = NULL; }
+  tick_timer_service_unsubscribe();
+  menu_redraw_cancel();
+  bulk_transfer_deinit();
+  request_queue_clear();
+  task_lists_free();
+  tasks_free();
   if (s_lists_window) window_destroy(s_lists_window);
   task_list_view_deinit();
   task_detail_view_deinit();
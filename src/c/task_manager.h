@@ -2,6 +2,8 @@
 #define TASK_MANAGER_H
 
 #include <pebble.h>
+#include "string_arena.h"
+#include "record.h"
 
 // API callback keys
 #define KEY_TYPE 0
@@ -14,6 +16,48 @@
 #define KEY_PRIORITY 7
 #define KEY_NOTES 8
 #define KEY_COUNT 9
+#define KEY_BATCH 10
+#define KEY_ARENA_SIZE 11
+#define KEY_LIST_ID 12
+#define KEY_VERSION 13
+#define KEY_LAYOUT 14
+#define KEY_INBOX_SIZE 15
+#define KEY_GENERATION 16
+#define KEY_TRACE 17
+#define KEY_TOTAL 18
+
+// Batched frames: record n of a frame is a byte array at KEY_RECORD_BASE + n;
+// KEY_IDX holds the list position of record 0 and KEY_BATCH the number of
+// records in the frame. Frames are packed up to the KEY_INBOX_SIZE the watch
+// reports with its list and task requests.
+#define KEY_RECORD_BASE 100
+#define MAX_BATCH_RECORDS 64
+
+// Paging: a task request carries in KEY_COUNT the most rows the watch holds.
+// Longer lists are answered with the full count but only the first rows;
+// further rows are asked for with a page request (KEY_IDX, KEY_COUNT).
+// A list the phone streams from the server is answered as soon as its first
+// rows are known: the count message carries the rows known so far and
+// KEY_TOTAL 0 (length not known yet), and the rows of the first window follow
+// as they arrive. Messages with KEY_TOTAL alone give the rows known so far
+// beyond the window; the one that also carries KEY_VERSION, the final length.
+//
+// Delta sync: a task request carries the KEY_VERSION the watch holds for the
+// list. If the phone has the same version it answers with a count message
+// whose KEY_LAYOUT describes the new list as runs of uint16 pairs
+// (old index, run length); runs starting at LAYOUT_NEW_ROWS are new or
+// changed rows that follow in batched frames at their new positions.
+#define LAYOUT_NEW_ROWS 0xFFFF
+
+// Streams: every list or task request carries a new KEY_GENERATION that the
+// phone echoes on each message of its answer. Messages of an older generation
+// are dropped and answered with a cancel (type 7) so the phone stops sending.
+
+// Task priorities as carried in the record flags
+#define PRIORITY_NONE 0
+#define PRIORITY_LOW 1
+#define PRIORITY_MEDIUM 2
+#define PRIORITY_HIGH 3
 
 // Navigation state
 typedef enum {
@@ -23,42 +67,90 @@ typedef enum {
 } AppState;
 
 // Data structures
+#define UUID_SIZE 16
+#define UUID_STRING_SIZE 37   // 36 chars + null terminator
+#define ID_MAX_SIZE 256       // longest id a record can carry + null terminator
+
+// Canonical UUID ids are kept as 16 binary bytes; any other provider id is
+// stored as a string in the owning arena.
+typedef union {
+  uint8_t uuid[UUID_SIZE];
+  uint16_t offset;
+} RecordId;
+
+// Strings (names, non-UUID ids) live in task_lists_arena / tasks_arena
 typedef struct {
-  char id[37];        // 37 bytes, 36 chars (UUID) + null terminator
-  char name[64];      // 64 bytes
-} TaskList;           // total: 101 bytes
+  RecordId id;        // 16 bytes
+  uint16_t name;      // 2 bytes, offset into task_lists_arena
+  uint8_t flags;      // 1 byte, RECORD_FLAG_*
+} TaskList;           // total: 20 bytes
+
+#define DUE_TEXT_SIZE 20      // "Wed Sep 30 12:45 PM" + null terminator
 
 typedef struct {
-  char id[37];        // 37 bytes, 36 chars (UUID) + null terminator
-  int8_t idx;         // 1 byte
-  char name[128];     // 128 bytes
-  int8_t priority;    // 1 byte
-  char due_date[32];  // 32 bytes
-  bool completed;     // 1 byte
-  char notes[256];    // 256 bytes
-} Task;               // total: 456 bytes
+  time_t due_date;    // 4 bytes, 0 when the task has no due date
+  RecordId id;        // 16 bytes
+  uint16_t name;      // 2 bytes, offset into tasks_arena
+  uint8_t flags;      // 1 byte, RECORD_FLAG_* (completed, priority, id kind)
+  char due_text[DUE_TEXT_SIZE];  // 20 bytes, friendly due date rendered off the draw path
+} Task;               // total: 44 bytes
+
+// Lists longer than TASKS_WINDOW_ROWS are paged: tasks[] then holds the window
+// of rows starting at tasks_first, moved a page at a time to follow the
+// selection. Rows not yet received have name == STRING_ARENA_NONE.
+#define TASKS_PAGE_ROWS 16
+#define TASKS_WINDOW_PAGES 3
+#define TASKS_WINDOW_ROWS (TASKS_PAGE_ROWS * TASKS_WINDOW_PAGES)
 
 // Global state (defined in task_manager.c)
 extern TaskList *task_lists;
 extern int task_lists_count;
 extern int task_lists_capacity;
+extern StringArena task_lists_arena;
 extern Task *tasks;
-extern int tasks_count;
-extern int tasks_capacity;
+extern int tasks_count;     // rows in the list
+extern int tasks_capacity;  // rows tasks[] can hold
+extern int tasks_first;     // row held in tasks[0]
+extern StringArena tasks_arena;
 extern int selected_list_index;
 extern int selected_task_index;
 extern AppState current_state;
 extern bool js_ready;
 extern bool tasks_loading;  // Flag to track if tasks are being fetched
-extern char s_time_buffer[32];  // Buffer for formatted dates
 
 // Shared utility functions
 time_t convert_iso_to_time_t(const char* iso_date_str);
 void convert_iso_to_friendly_date(const char* iso_date_str, char* buffer, size_t buffer_size);
+void format_friendly_date(time_t due_date, bool all_day, char* buffer, size_t buffer_size);
+void tasks_refresh_due_texts(void);
+
+// Record accessors
+const char* task_list_get_name(const TaskList *list);
+const char* task_list_get_id(const TaskList *list, char *buffer, size_t buffer_size);
+Task* task_at(int row);  // NULL until the row has been received
+void tasks_ensure_loaded(int row);
+const char* task_get_name(const Task *task);
+const char* task_get_id(const Task *task, char *buffer, size_t buffer_size);
+bool task_is_completed(const Task *task);
+int task_get_priority(const Task *task);
+void task_set_completed(Task *task);
+void task_lists_free(void);
+void tasks_free(void);
+
+// Record storage, shared by the AppMessage stream and the persisted snapshot
+bool task_lists_alloc(int count, size_t arena_size);
+bool tasks_alloc(int count, size_t arena_size);
+bool task_list_store_record(int index, const Record *record);
+bool task_store_record(int index, const Record *record);
+void task_list_to_record(const TaskList *list, Record *record);
+void task_to_record(const Task *task, Record *record);
 
 // AppMessage functions
-void fetch_tasks(const char *list_id);
+void fetch_tasks(const char *list_id, uint32_t version);
 void complete_task(const char *task_id, const char *list_name);
+void fetch_task_notes(const char *list_id, const char *task_id);
+void fetch_task_page(const char *list_id, int first, int count);
+void cancel_stream(uint32_t generation);
 void fetch_task_lists(void);
 
 #endif // TASK_MANAGER_H
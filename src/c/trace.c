@@ -0,0 +1,120 @@
+#include <pebble.h>
+#include "trace.h"
+
+#ifdef TRACE_ENABLED
+#include "task_manager.h"
+#include "request_queue.h"
+
+typedef struct {
+  uint32_t time_ms;
+  uint32_t arg;
+  uint8_t event;
+} TraceEntry;
+
+static TraceEntry s_entries[TRACE_ENTRIES];
+static uint32_t s_recorded;  // events ever recorded; the ring holds the last TRACE_ENTRIES
+static time_t s_start_s;
+static uint16_t s_start_ms;
+static size_t s_heap_low;    // lowest heap_bytes_free() seen
+static size_t s_heap_logged; // low-water mark of the last TRACE_HEAP_LOW entry
+
+// Dump in progress: one chunk is queued at a time, so chunks never evict each
+// other from the request queue, and recording pauses until the last is done
+static bool s_dumping;
+static uint32_t s_dump_oldest;  // value of s_recorded of the oldest entry dumped
+static uint32_t s_dump_count;
+static uint32_t s_dump_first;   // first entry of the chunk queued
+
+static void append(TraceEvent event, uint32_t arg) {
+  time_t s;
+  uint16_t ms;
+  time_ms(&s, &ms);
+
+  TraceEntry *entry = &s_entries[s_recorded % TRACE_ENTRIES];
+  entry->time_ms = (uint32_t)(s - s_start_s) * 1000 + ms - s_start_ms;
+  entry->event = event;
+  entry->arg = arg;
+  s_recorded++;
+}
+
+void trace_record(TraceEvent event, uint32_t arg) {
+  if (s_dumping) {
+    return;
+  }
+  if (s_recorded == 0) {
+    time_ms(&s_start_s, &s_start_ms);
+    s_heap_low = s_heap_logged = heap_bytes_free();
+  }
+  append(event, arg);
+
+  size_t heap_free = heap_bytes_free();
+  if (heap_free < s_heap_low) {
+    s_heap_low = heap_free;
+    if (s_heap_logged - heap_free >= TRACE_HEAP_STEP) {
+      s_heap_logged = heap_free;
+      append(TRACE_HEAP_LOW, heap_free);
+    }
+  }
+}
+
+static void write_uint32(uint8_t *out, uint32_t value) {
+  out[0] = value & 0xFF;
+  out[1] = (value >> 8) & 0xFF;
+  out[2] = (value >> 16) & 0xFF;
+  out[3] = (value >> 24) & 0xFF;
+}
+
+static void queue_chunk(void);
+
+static void chunk_done(bool sent) {
+  if (!sent) {
+    // The phone posts the trace with the gap marked
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Lost trace entries from %lu", (unsigned long)s_dump_first);
+  }
+  s_dump_first += TRACE_CHUNK_ENTRIES;
+  queue_chunk();
+}
+
+static void queue_chunk(void) {
+  if (s_dump_first >= s_dump_count) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Sent %lu trace entries", (unsigned long)s_dump_count);
+    s_dumping = false;
+    return;
+  }
+
+  uint8_t chunk[TRACE_CHUNK_ENTRIES * TRACE_ENTRY_SIZE];
+  uint32_t n = s_dump_count - s_dump_first < TRACE_CHUNK_ENTRIES ? s_dump_count - s_dump_first : TRACE_CHUNK_ENTRIES;
+  for (uint32_t i = 0; i < n; i++) {
+    const TraceEntry *entry = &s_entries[(s_dump_oldest + s_dump_first + i) % TRACE_ENTRIES];
+    uint8_t *out = &chunk[i * TRACE_ENTRY_SIZE];
+    write_uint32(out, entry->time_ms);
+    out[4] = entry->event;
+    write_uint32(out + 5, entry->arg);
+  }
+
+  RequestField fields[] = {
+    REQUEST_DATA(KEY_TRACE, chunk, n * TRACE_ENTRY_SIZE),
+    REQUEST_UINT(KEY_IDX, s_dump_first),
+    REQUEST_UINT(KEY_COUNT, s_dump_count),
+  };
+  if (!request_queue_send_notify(8, REQUEST_PRIORITY_TRACE, fields, ARRAY_LENGTH(fields), chunk_done)) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not queue trace entries from %lu", (unsigned long)s_dump_first);
+    s_dumping = false;
+  }
+}
+
+void trace_dump(void) {
+  if (s_dumping) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Trace dump already in progress");
+    return;
+  }
+  // End with the exact low-water mark
+  append(TRACE_HEAP_LOW, s_heap_low);
+
+  s_dump_count = s_recorded < TRACE_ENTRIES ? s_recorded : TRACE_ENTRIES;
+  s_dump_oldest = s_recorded - s_dump_count;
+  s_dump_first = 0;
+  s_dumping = true;
+  queue_chunk();
+}
+#endif
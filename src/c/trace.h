@@ -0,0 +1,51 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <pebble.h>
+
+// Performance trace, compiled in only when TRACE_ENABLED is defined
+// (TRACE=1 pebble build). Events go to a fixed ring buffer instead of the
+// log, so recording costs a few stores. A long press of Select on the lists
+// menu sends the buffer to the phone, which posts it to the server.
+#if defined(PBL_PLATFORM_APLITE)
+#define TRACE_ENTRIES 64
+#else
+#define TRACE_ENTRIES 256
+#endif
+#define TRACE_ENTRY_SIZE 9        // packed: uint32 time_ms, uint8 event, uint32 arg
+#define TRACE_CHUNK_ENTRIES 48    // entries per dump message; fits the outbox
+#define TRACE_HEAP_STEP 256       // heap low-water drop worth an entry
+
+// Event ids; index.js maps them to names
+typedef enum {
+  TRACE_INBOX = 1,      // message received; arg: message type
+  TRACE_PARSED,         // batch unpacked; arg: records stored
+  TRACE_MENU_RELOAD,    // coalesced menu reload; arg: 0
+  TRACE_DRAW_ROW,       // draw_row started; arg: row
+  TRACE_DRAW_ROW_DONE,  // draw_row finished; arg: row
+  TRACE_HEAP_LOW        // new heap low-water mark; arg: bytes free
+} TraceEvent;
+
+#ifdef TRACE_ENABLED
+// Record an event with a timestamp in ms since the first event
+void trace_record(TraceEvent event, uint32_t arg);
+
+// Send the buffer, oldest event first, as type 8 messages: KEY_TRACE holds
+// packed entries, KEY_IDX the first entry and KEY_COUNT the total. Each chunk
+// is queued once the previous one is done; events are not recorded meanwhile.
+void trace_dump(void);
+
+#define TRACE(event, arg) trace_record((event), (arg))
+#else
+#define TRACE(event, arg)
+#endif
+
+// Logging on the menu draw paths, compiled in only when DRAW_LOG_ENABLED is
+// defined (DEBUG=1 pebble build); it costs more than the drawing itself
+#ifdef DRAW_LOG_ENABLED
+#define DRAW_LOG(...) APP_LOG(APP_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define DRAW_LOG(...)
+#endif
+
+#endif // TRACE_H
@@ -13,6 +13,73 @@ var provider = localStorage.getItem('api_provider') || DEFAULT_PROVIDER;
 var API_BASE = "http://" + hostname + ":" + port + "/api";
 var listNameToId = {};  // Cache list name -> ID for task completion
 
+// Message keys (numbers generated from package.json messageKeys)
+var keys = require('message_keys');
+
+// AppMessage framing - must match the batch keys in task_manager.h. The watch
+// sizes its inbox from its free heap and reports it with list and task requests.
+var DEFAULT_INBOX_SIZE = 512;  // APP_MESSAGE_INBOX_MIN in task_manager.c
+var watchInboxSize = DEFAULT_INBOX_SIZE;
+var KEY_RECORD_BASE = 100;
+var MAX_BATCH_RECORDS = 64;
+var DICT_HEADER_SIZE = 1;   // tuple count
+var TUPLE_HEADER_SIZE = 7;  // key (4) + type (1) + length (2)
+
+// Binary record layout - must match RECORD_VERSION and RECORD_FLAG_* in record.h
+var RECORD_VERSION = 2;
+var RECORD_FLAG_COMPLETED = 0x01;
+var RECORD_FLAG_PRIORITY_SHIFT = 1;
+var RECORD_FLAG_HAS_DUE = 0x08;
+var RECORD_FLAG_UUID_ID = 0x10;
+var RECORD_FLAG_ALL_DAY = 0x20;
+var UUID_REGEX = /^[0-9A-F]{8}-[0-9A-F]{4}-[0-9A-F]{4}-[0-9A-F]{4}-[0-9A-F]{12}$/;
+var PRIORITY_NONE = 0;
+var PRIORITY_LOW = 1;
+var PRIORITY_MEDIUM = 2;
+var PRIORITY_HIGH = 3;
+
+// String limits (bytes) for names and ids stored in the watch's string arenas
+var MAX_ID_BYTES = 255;
+var MAX_LIST_NAME_BYTES = 63;
+var MAX_TASK_NAME_BYTES = 127;
+var MAX_NOTES_BYTES = 255;  // NOTES_MAX_LENGTH in notes_cache.h, minus terminator
+
+// Delta sync - must match KEY_LAYOUT and LAYOUT_NEW_ROWS in task_manager.h
+var LAYOUT_NEW_ROWS = 0xFFFF;
+var TASKS_CACHE_KEY = 'tasks_cache';  // last task records sent to the watch, for diffing
+var pagedTasks = null;  // records of the list on the watch, served in pages on request
+
+// Streams - must match KEY_GENERATION in task_manager.h. Each list or task
+// request starts a stream tagged with the watch's generation, echoed on every
+// message sent for it. A newer request of the same type, or a cancel (type 7)
+// from the watch, stops the stream and aborts its request to the server.
+var streams = {};  // message type -> {type, generation, xhr, cancelled, page}
+
+function startStream(type, generation) {
+  cancelStream(streams[type]);
+  var stream = { type: type, generation: generation || 0, xhr: null, cancelled: false, page: null };
+  streams[type] = stream;
+  return stream;
+}
+
+function cancelStream(stream) {
+  if (!stream || stream.cancelled) {
+    return;
+  }
+  console.log('Cancelling stream ' + stream.generation + ' (type ' + stream.type + ')');
+  stream.cancelled = true;
+  if (stream.page) {
+    stream.page.cancelled = true;
+  }
+  if (stream.xhr) {
+    stream.xhr.abort();
+    stream.xhr = null;
+  }
+  if (streams[stream.type] === stream) {
+    delete streams[stream.type];
+  }
+}
+
 console.log('Using API:', API_BASE);
 
 // Function to update API base URL
@@ -28,18 +95,153 @@ function updateAPIBase() {
 Pebble.addEventListener('ready', function(e) {
   console.warn('=== PEBBLE READY ===');
   console.log('PebbleKit JS ready!');
-  // Don't fetch here, let the watch app request when needed
-  
-  // Send ready signal to watch (KEY_TYPE = 0)
-  Pebble.sendAppMessage({'KEY_TYPE': 0}, 
+  // Start on what the watch will ask for while it launches
+  prefetchOnReady();
+
+  sendReady();
+});
+
+// Send the ready signal to the watch (KEY_TYPE = 0). The watch only asks for
+// lists once it has it, so a NACKed ready is resent with the paced backoff.
+function sendReady() {
+  sendRetried('ready message', {'KEY_TYPE': 0}, 1);
+}
+
+// Send a single reply the watch waits for, resending it with the paced backoff
+// while it is NACKed, up to SEND_ATTEMPTS times
+var SEND_ATTEMPTS = 10;
+
+function sendRetried(label, dict, attempt) {
+  sendPaced(dict,
+    function() {
+      console.log('Sent ' + label + ' to watch');
+    },
+    function() {
+      if (attempt < SEND_ATTEMPTS) {
+        sendRetried(label, dict, attempt + 1);
+      } else {
+        console.log('Failed to send ' + label + ' to watch after ' + attempt + ' attempts');
+      }
+    }
+  );
+}
+
+// Message recorder: with 'record_messages' set (configuration page), every
+// AppMessage sent to or received from the watch is logged as a "[rec] {json}"
+// line with the ms since launch, for tools/replay to replay.
+var RECORD_PREFIX = '[rec] ';
+var recordMessages = localStorage.getItem('record_messages') === 'true';
+var recordStart = Date.now();
+var recordSequence = 0;
+var keyNames = {};
+for (var keyName in keys) {
+  keyNames[keys[keyName]] = keyName;
+}
+
+// Dictionary with message key names instead of numbers (record keys stay numbers)
+function namedPayload(dict) {
+  var named = {};
+  for (var key in dict) {
+    var value = dict[key];
+    named[keyNames[key] || key] = (value && value.length !== undefined && typeof value !== 'string') ?
+      Array.prototype.slice.call(value) : value;
+  }
+  return named;
+}
+
+function recordMessage(entry) {
+  if (!recordMessages) {
+    return;
+  }
+  entry.t = Date.now() - recordStart;
+  console.log(RECORD_PREFIX + JSON.stringify(entry));
+}
+
+// Pebble.sendAppMessage, recorded: a send, then its ack or nack with the same seq
+function sendAppMessage(dict, onAck, onNack) {
+  var seq = ++recordSequence;
+  recordMessage({ seq: seq, event: 'send', payload: namedPayload(dict) });
+  Pebble.sendAppMessage(dict,
     function(e) {
-      console.log('Ready message sent to watch successfully!');
+      recordMessage({ seq: seq, event: 'ack' });
+      if (onAck) onAck(e);
     },
     function(e) {
-      console.log('Failed to send ready message to watch');
+      recordMessage({ seq: seq, event: 'nack', error: e && e.error ? e.error.message || e.error : null });
+      if (onNack) onNack(e);
     }
   );
-});
+}
+
+// Adaptive pacing of streamed messages (AIMD). The next message goes out as
+// soon as the previous one is ACKed, as long as the send rate stays under
+// paceRate messages/s. Every ACK raises the rate by PACE_RATE_STEP, less the
+// share of recent sends NACKed (doubles it until the first NACK), unless ACKs
+// are getting slow (smoothed latency over PACE_SLOW_ACK_FACTOR times the best
+// seen). Every NACK halves it, and the retry waits out the wider gap. The rate
+// carries over between streams, since they share the link.
+var PACE_START_RATE = 5;    // messages/s, the old fixed 200 ms gap
+var PACE_MIN_RATE = 0.25;   // at most 4 s between messages
+var PACE_MAX_RATE = 50;
+var PACE_RATE_STEP = 1;
+var PACE_SLOW_ACK_FACTOR = 2;
+var PACE_RETRY_MS = 100;    // least wait before resending a NACKed message
+var paceRate = PACE_START_RATE;
+var paceSlowStart = true;
+var paceAckLatency = 0;       // smoothed ms from send to ACK
+var paceBestAckLatency = 0;
+var paceNackRate = 0;         // smoothed share of sends NACKed
+
+// Time to wait after a message took elapsed ms, to keep to paceRate
+function paceGap(elapsed) {
+  return Math.max(0, Math.round(1000 / paceRate - elapsed));
+}
+
+function paceStatus() {
+  return 'pace ' + paceRate.toFixed(1) + ' msg/s, ACK ' + Math.round(paceAckLatency) + 'ms, ' +
+         Math.round(paceNackRate * 100) + '% NACKed';
+}
+
+// Send a message of a stream: next() runs once it is ACKed and the pace allows
+// another send; after a NACK, retry() runs once the widened gap has passed
+function sendPaced(dict, next, retry) {
+  var sentAt = Date.now();
+  sendAppMessage(dict,
+    function(e) {
+      var latency = Date.now() - sentAt;
+      paceAckLatency = paceAckLatency ? paceAckLatency * 0.8 + latency * 0.2 : latency;
+      paceBestAckLatency = paceBestAckLatency ? Math.min(paceBestAckLatency, latency) : latency;
+      paceNackRate *= 0.9;
+      if (paceAckLatency <= paceBestAckLatency * PACE_SLOW_ACK_FACTOR) {
+        paceRate = Math.min(PACE_MAX_RATE, paceSlowStart ? paceRate * 2 :
+                            paceRate + PACE_RATE_STEP * (1 - paceNackRate));
+      }
+      var gap = paceGap(latency);
+      if (gap > 0) {
+        setTimeout(next, gap);
+      } else {
+        next();
+      }
+    },
+    function(e) {
+      paceSlowStart = false;
+      paceNackRate = paceNackRate * 0.9 + 0.1;
+      paceRate = Math.max(PACE_MIN_RATE, paceRate / 2);
+      var gap = Math.max(PACE_RETRY_MS, paceGap(Date.now() - sentAt));
+      console.log('Message NACKed, retrying in ' + gap + 'ms (' + paceStatus() + ')');
+      setTimeout(retry, gap);
+    }
+  );
+}
+
+// Performance trace - must match TraceEvent and TRACE_ENTRY_SIZE in trace.h
+var TRACE_EVENTS = [null, 'inbox', 'parsed', 'menu_reload', 'draw_row', 'draw_row_done', 'heap_low'];
+var TRACE_ENTRY_SIZE = 9;
+var TRACE_TIMEOUT_MS = 30000;  // wait for a missing chunk, then post without it
+var traceEntries = [];         // by index; missing entries are undefined
+var traceCount = 0;            // entries of the dump being received, 0 if none
+var traceReceived = 0;
+var traceTimer = null;
 
 // Listen for messages from the watch
 Pebble.addEventListener('appmessage', function(e) {
@@ -47,45 +249,147 @@ Pebble.addEventListener('appmessage', function(e) {
   console.log('AppMessage received!');
   var payload = e.payload;
   console.log('Payload = ' + JSON.stringify(payload));
+  recordMessage({ event: 'receive', payload: namedPayload(payload) });
 
   // Acknowledge receipt of the message
   //e.ack();
 
   //if (payload[KEY_TYPE] !== undefined) {
     console.log('Processing payload with KEY_TYPE:', payload.KEY_TYPE);
+    if (payload.KEY_INBOX_SIZE) {
+      watchInboxSize = payload.KEY_INBOX_SIZE;
+    }
     if (payload.KEY_TYPE === 1) {
       // Fetch task lists
       console.log('KEY_TYPE 1: Fetching task lists');
-      fetchTaskLists();
+      fetchTaskLists(startStream(1, payload.KEY_GENERATION));
     } else if (payload.KEY_TYPE === 2) {
       // Fetch tasks for a specific list
       var listId = payload.KEY_ID;
-      console.log('KEY_TYPE 2: Fetching tasks for list id:', listId);
-      fetchTasks(listId);
+      console.log('KEY_TYPE 2: Fetching tasks for list id:', listId, 'watch version:', payload.KEY_VERSION);
+      fetchTasks(listId, payload.KEY_VERSION || 0, payload.KEY_COUNT || 0,
+                 startStream(2, payload.KEY_GENERATION));
     } else if (payload.KEY_TYPE === 3) {
       // Complete a task
       var taskId = payload.KEY_ID;
       var listName = payload.KEY_LIST_NAME;
       console.log('KEY_TYPE 3: Completing task', taskId, 'in list', listName);
       completeTask(taskId, listName);
+    } else if (payload.KEY_TYPE === 5) {
+      // Fetch notes for one task
+      console.log('KEY_TYPE 5: Fetching notes for task', payload.KEY_ID);
+      fetchTaskNotes(payload.KEY_LIST_ID, payload.KEY_ID);
+    } else if (payload.KEY_TYPE === 6) {
+      // Send a page of the task list being viewed
+      console.log('KEY_TYPE 6: Sending tasks', payload.KEY_IDX, '+', payload.KEY_COUNT, 'of list', payload.KEY_ID);
+      sendTaskPage(payload.KEY_ID, payload.KEY_IDX, payload.KEY_COUNT, payload.KEY_GENERATION || 0);
+    } else if (payload.KEY_TYPE === 7) {
+      // The watch no longer wants a stream
+      console.log('KEY_TYPE 7: Cancelling stream', payload.KEY_GENERATION);
+      for (var type in streams) {
+        if (streams[type].generation === payload.KEY_GENERATION) {
+          cancelStream(streams[type]);
+        }
+      }
+    } else if (payload.KEY_TYPE === 8) {
+      // Part of a performance trace dump
+      receiveTraceChunk(payload.KEY_IDX, payload.KEY_COUNT, payload.KEY_TRACE || []);
     }
   }
 //}
 );
 
-// Fetch task list names
-function fetchTaskLists() {
-  console.log('Fetching task lists from API...');
+// Speculative prefetch: on ready, the lists and the tasks of the list opened
+// last (the one in the tasks cache) are requested before the watch asks for
+// them, so that the round trips overlap the app's launch. A fetch for the same
+// URL within PREFETCH_MAX_AGE_MS takes over the prefetched request instead of
+// making its own.
+var PREFETCH_MAX_AGE_MS = 30000;
+var prefetches = {};  // url -> {xhr, startedAt, done, onload}
+
+function prefetchOnReady() {
+  prefetches = {};
+  prefetch(listsUrl(), null);
+  var cache = loadTasksCache();
+  if (cache && cache.listId) {
+    // The same conditional request fetchTasks makes for a cached list
+    prefetch(tasksUrl(cache.listId), cache.version);
+  }
+}
 
+function prefetch(url, version) {
   var xhr = new XMLHttpRequest();
-  xhr.open('GET', API_BASE + '/lists?' + 'provider=' + provider, true);
+  var entry = { xhr: xhr, startedAt: Date.now(), done: false, onload: null };
+  prefetches[url] = entry;
+  console.log('Prefetching:', url);
+  xhr.open('GET', url, true);
+  if (version) {
+    xhr.setRequestHeader('If-None-Match', '"' + version + '"');
+  }
   xhr.onload = function() {
-    if (xhr.readyState === 4) {
+    entry.done = true;
+    if (entry.onload) {
+      entry.onload(xhr);
+    }
+  };
+  xhr.onerror = function() {
+    if (entry.onload) {
+      entry.onload(xhr);
+    } else if (prefetches[url] === entry) {
+      // Not wanted yet: let the fetch make its own request
+      delete prefetches[url];
+    }
+  };
+  xhr.send();
+}
+
+// Hand the prefetched response for url to onload(xhr), now or when it
+// arrives. Returns false if there is no usable prefetch.
+function takePrefetch(url, stream, onload) {
+  var entry = prefetches[url];
+  delete prefetches[url];
+  if (!entry) {
+    return false;
+  }
+  if (Date.now() - entry.startedAt > PREFETCH_MAX_AGE_MS) {
+    if (!entry.done) {
+      entry.xhr.abort();
+    }
+    return false;
+  }
+  console.log('Using prefetched', url);
+  if (entry.done) {
+    onload(entry.xhr);
+  } else {
+    stream.xhr = entry.xhr;
+    entry.onload = onload;
+  }
+  return true;
+}
+
+function listsUrl() {
+  return API_BASE + '/lists?' + 'provider=' + provider;
+}
+
+// Every task of the list (limit=0); the watch pages long lists itself
+function tasksUrl(listId) {
+  return API_BASE + '/lists/' + encodeURIComponent(listId) + '/tasks?' + 'provider=' + provider +
+         '&limit=0&tzOffset=' + new Date().getTimezoneOffset();
+}
+
+// Fetch task list names
+function fetchTaskLists(stream) {
+  console.log('Fetching task lists from API...');
+
+  var url = listsUrl();
+  function onload(xhr) {
+    stream.xhr = null;
+    if (xhr.readyState === 4 && !stream.cancelled) {
       if (xhr.status === 200) {
         try {
           var response = JSON.parse(xhr.responseText);
           console.log('Received lists:', JSON.stringify(response));
-          sendTaskListsToWatch(response.lists);
+          sendTaskListsToWatch(response.lists, stream);
         } catch (e) {
           console.log('Error parsing response:', e);
         }
@@ -93,80 +397,246 @@ function fetchTaskLists() {
         console.log('Failed to fetch task lists. Status:', xhr.status);
       }
     }
+  }
+  if (takePrefetch(url, stream, onload)) {
+    return;
+  }
+
+  var xhr = new XMLHttpRequest();
+  stream.xhr = xhr;
+  xhr.open('GET', url, true);
+  xhr.onload = function() {
+    onload(xhr);
   };
   xhr.send();
 }
 
-// Send task lists to the watch sequentially with delays to avoid APP_MSG_BUSY
-function sendTaskListsToWatch(lists) {
-  // Cache list name -> ID mapping for task completion
-  listNameToId = {};
-  for (var i = 0; i < lists.length; i++) {
-    var id = lists[i].id || i;
-    var name = lists[i].name || lists[i];
-    listNameToId[name] = id;
+// Number of bytes a string occupies once UTF-8 encoded
+function utf8Length(str) {
+  return unescape(encodeURIComponent(str)).length;
+}
+
+// Truncate a string so its UTF-8 encoding fits in maxBytes without splitting a character
+function truncateUtf8(str, maxBytes) {
+  while (str.length > 0 && utf8Length(str) > maxBytes) {
+    str = str.slice(0, -1);
   }
-  console.log('Cached list name->ID map:', JSON.stringify(listNameToId));
+  return str;
+}
+
+// UTF-8 bytes of a string, truncated to maxBytes without splitting a character
+function utf8Bytes(str, maxBytes) {
+  var encoded = unescape(encodeURIComponent(truncateUtf8(String(str), maxBytes)));
+  var bytes = [];
+  for (var i = 0; i < encoded.length; i++) {
+    bytes.push(encoded.charCodeAt(i));
+  }
+  return bytes;
+}
+
+// Encode a list or task as a binary record (layout documented in record.h)
+function encodeRecord(flags, dueEpoch, id, name, maxNameBytes) {
+  var due = dueEpoch || 0;
+  if (due) {
+    flags |= RECORD_FLAG_HAS_DUE;
+  }
+
+  // Canonical upper-case UUIDs travel (and are stored on the watch) as 16 raw bytes
+  var idBytes;
+  if (UUID_REGEX.test(id)) {
+    flags |= RECORD_FLAG_UUID_ID;
+    idBytes = [];
+    var hex = id.replace(/-/g, '');
+    for (var i = 0; i < 32; i += 2) {
+      idBytes.push(parseInt(hex.substr(i, 2), 16));
+    }
+  } else {
+    idBytes = utf8Bytes(id, MAX_ID_BYTES);
+  }
+  var nameBytes = utf8Bytes(name, maxNameBytes);
+
+  return [RECORD_VERSION, flags,
+          due & 0xff, (due >>> 8) & 0xff, (due >>> 16) & 0xff, (due >>> 24) & 0xff,
+          idBytes.length].concat(idBytes, [nameBytes.length], nameBytes);
+}
+
+// Map provider priorities onto the watch's PRIORITY_* levels.
+// Reminders uses 1-4 high, 5 medium, 6-9 low (0 = none); Microsoft uses importance.
+function priorityLevel(task) {
+  if (task.importance) {
+    return task.importance === 'high' ? PRIORITY_HIGH :
+           (task.importance === 'low' ? PRIORITY_LOW : PRIORITY_NONE);
+  }
+  var priority = parseInt(task.priority) || 0;
+  if (priority <= 0) return PRIORITY_NONE;
+  if (priority < 5) return PRIORITY_HIGH;
+  if (priority === 5) return PRIORITY_MEDIUM;
+  return PRIORITY_LOW;
+}
+
+// Bytes a record's strings take in the watch's string arena (each NUL terminated)
+function recordArenaSize(bytes) {
+  var idLength = bytes[6];
+  var nameLength = bytes[7 + idLength];
+  return (nameLength + 1) + ((bytes[1] & RECORD_FLAG_UUID_ID) ? 0 : idLength + 1);
+}
+
+// Pack binary records into as few AppMessage frames as fit in the watch inbox.
+// Record n of a frame is written at KEY_RECORD_BASE + n and lands at row
+// KEY_IDX + n; positions (default 0, 1, 2, ...) give each record's row, and a
+// gap starts a new frame; sendFrames adds the stream generation. Returns the
+// frames and the string arena size the watch needs to hold all records.
+function packFrames(type, records, positions) {
+  var frames = [];
+  var arenaSize = 0;
+  var frame = null;
+  var frameSize = 0;
+  var n = 0;
+
+  for (var i = 0; i < records.length; i++) {
+    var bytes = records[i];
+    var row = positions ? positions[i] : i;
+    var recordSize = TUPLE_HEADER_SIZE + bytes.length;
+    arenaSize += recordArenaSize(bytes);
+
+    if (frame && (frameSize + recordSize > watchInboxSize || n >= MAX_BATCH_RECORDS ||
+                  row !== frame[keys.KEY_IDX] + n)) {
+      frames.push(frame);
+      frame = null;
+    }
+    if (!frame) {
+      frame = {};
+      frame[keys.KEY_TYPE] = type;
+      frame[keys.KEY_IDX] = row;
+      frame[keys.KEY_BATCH] = 0;
+      frameSize = DICT_HEADER_SIZE + 4 * (TUPLE_HEADER_SIZE + 4);  // type, index, batch, generation
+      n = 0;
+    }
+
+    frame[KEY_RECORD_BASE + n] = bytes;
+    n++;
+    frame[keys.KEY_BATCH] = n;
+    frameSize += recordSize;
+  }
+
+  if (frame) {
+    frames.push(frame);
+  }
+  return { frames: frames, arenaSize: arenaSize };
+}
 
+// Send batched frames one at a time, each after the previous was acknowledged,
+// until all are sent (then onDone runs, if given) or the stream is cancelled
+function sendFrames(label, frames, stream, onDone) {
   var currentIndex = 0;
-  var retryDelay = 500;
 
-  function sendNextList() {
-    if (currentIndex >= lists.length) {
-      console.log('All task lists sent successfully');
+  function sendNextFrame() {
+    if (stream.cancelled) {
+      console.log('Stopped sending ' + label + ' after ' + currentIndex + '/' + frames.length + ' messages');
+      return;
+    }
+    if (currentIndex >= frames.length) {
+      console.log('All ' + label + ' sent successfully (' + frames.length + ' messages, ' + paceStatus() + ')');
+      if (onDone) onDone();
       return;
     }
 
-    var dict = {
-      'KEY_TYPE': 1,
-      'KEY_ID': lists[currentIndex].id || currentIndex,
-      'KEY_NAME': lists[currentIndex].name || lists[currentIndex]
-    };
-
-    Pebble.sendAppMessage(dict,
-      function(e) {
-        console.log('Task list ' + (currentIndex + 1) + '/' + lists.length + ' sent successfully');
-        retryDelay = 500;
+    frames[currentIndex][keys.KEY_GENERATION] = stream.generation;
+    sendPaced(frames[currentIndex],
+      function() {
+        console.log(label + ' frame ' + (currentIndex + 1) + '/' + frames.length + ' sent successfully');
         currentIndex++;
-        setTimeout(sendNextList, 200);
+        sendNextFrame();
       },
-      function(e) {
-        console.log('Error sending task list ' + (currentIndex + 1) + ', retrying in ' + retryDelay + 'ms');
-        setTimeout(sendNextList, retryDelay);
-        retryDelay = Math.min(retryDelay * 2, 4000);
-      }
+      sendNextFrame
     );
   }
 
+  sendNextFrame();
+}
+
+// Send a count message followed by the batched frames, then run onDone (if given).
+// countFields are extra tuples for the count message (version, delta layout).
+function sendFramesToWatch(label, type, count, packed, countFields, stream, onDone) {
+  var frames = packed.frames;
+  if (stream.cancelled) {
+    return;
+  }
+
   // Send count first so the watch can allocate memory
-  var countDict = { 'KEY_TYPE': 1, 'KEY_COUNT': lists.length };
-  Pebble.sendAppMessage(countDict,
-    function(e) {
-      console.log('Task lists count (' + lists.length + ') sent, now sending items...');
-      setTimeout(sendNextList, 200);
+  var countDict = {};
+  countDict[keys.KEY_TYPE] = type;
+  countDict[keys.KEY_COUNT] = count;
+  countDict[keys.KEY_ARENA_SIZE] = packed.arenaSize;
+  countDict[keys.KEY_GENERATION] = stream.generation;
+  for (var key in countFields) {
+    countDict[key] = countFields[key];
+  }
+  sendPaced(countDict,
+    function() {
+      console.log(label + ' count (' + count + ') sent, now sending ' + frames.length + ' frames...');
+      if (frames.length > 0) {
+        sendFrames(label, frames, stream, onDone);
+      } else if (onDone) {
+        onDone();
+      }
     },
-    function(e) {
-      console.log('Error sending task lists count, retrying...');
-      setTimeout(function() { sendTaskListsToWatch(lists); }, 500);
+    function() {
+      sendFramesToWatch(label, type, count, packed, countFields, stream, onDone);
     }
   );
 }
 
-// Fetch tasks for a specific list
-function fetchTasks(listId) {
+// Send task lists to the watch, packed into batched frames
+function sendTaskListsToWatch(lists, stream) {
+  // Cache list name -> ID mapping for task completion
+  listNameToId = {};
+  for (var i = 0; i < lists.length; i++) {
+    var id = lists[i].id || i;
+    var name = lists[i].name || lists[i];
+    listNameToId[name] = id;
+  }
+  console.log('Cached list name->ID map:', JSON.stringify(listNameToId));
+
+  var records = lists.map(function(list) {
+    return encodeRecord(0, 0, list.id || list.name || list, list.name || list, MAX_LIST_NAME_BYTES);
+  });
+  sendFramesToWatch('task lists', 1, lists.length, packFrames(1, records), {}, stream);
+}
+
+// Fetch tasks for a specific list. watchVersion is the change version of the
+// tasks the watch holds for this list (0 if none); when it matches our cache
+// only the differences are sent. Lists longer than watchRows are paged.
+function fetchTasks(listId, watchVersion, watchRows, stream) {
   console.log('Fetching tasks for list from API: ' + listId);
 
-  var xhr = new XMLHttpRequest();
-  var url = API_BASE + '/lists/' + encodeURIComponent(listId) + '/tasks?' + 'provider=' + provider;
-  console.log('Request URL:', url);
-  xhr.open('GET', url, true);
-  xhr.onload = function() {
-    if (xhr.readyState === 4) {
-      if (xhr.status === 200) {
+  var cache = loadTasksCache();
+  var base = cache && cache.listId === listId ? cache : null;
+
+  var url = tasksUrl(listId);
+  if (!base) {
+    // Nothing to revalidate or diff against: stream it
+    streamTasks(listId, url + '&stream=ndjson', watchRows, stream);
+    return;
+  }
+
+  function onload(xhr) {
+    stream.xhr = null;
+    if (xhr.readyState === 4 && !stream.cancelled) {
+      if (xhr.status === 304 && base) {
+        console.log('Tasks unchanged at version', base.version);
+        sendTasksToWatch(base, base, watchVersion, watchRows, stream);
+      } else if (xhr.status === 200) {
         try {
           var response = JSON.parse(xhr.responseText);
           console.log('Received tasks:', JSON.stringify(response));
-          sendTasksToWatch(response.tasks);
+          var update = {
+            listId: listId,
+            version: response.version || 0,
+            records: encodeTasks(response.tasks || [])
+          };
+          saveTasksCache(update);
+          sendTasksToWatch(update, base, watchVersion, watchRows, stream);
         } catch (e) {
           console.log('Error parsing response:', e);
         }
@@ -174,30 +644,194 @@ function fetchTasks(listId) {
         console.log('Failed to fetch tasks. Status:', xhr.status);
       }
     }
+  }
+  if (takePrefetch(url, stream, onload)) {
+    return;
+  }
+
+  var xhr = new XMLHttpRequest();
+  stream.xhr = xhr;
+  console.log('Request URL:', url);
+  xhr.open('GET', url, true);
+  if (base.version) {
+    xhr.setRequestHeader('If-None-Match', '"' + base.version + '"');
+  }
+  xhr.onload = function() {
+    onload(xhr);
   };
   xhr.send();
 }
 
-// Helper function to pad numbers with leading zeros
-function pad(num) {
-  return (num < 10 ? '0' : '') + num;
-}
+// Fetch a list as NDJSON, one task per line (see the server's streamTasks), and
+// encode each task as its line arrives. The watch gets the rows known so far as
+// soon as the first lines are in, as a list of unknown length (KEY_TOTAL 0);
+// the rest of its first watchRows rows follow as they arrive, then the final
+// length and version (KEY_TOTAL, KEY_VERSION). Rows past the window are paged
+// in on request. A list complete before its first rows went out is sent as
+// fetchTasks would send it. Without onprogress support everything is read in
+// onload, as before.
+function streamTasks(listId, url, watchRows, stream) {
+  var records = [];
+  var version = 0;
+  var complete = false;
+  var opened = false;   // the count message went out
+  var sending = false;  // frames or a length message are on their way
+  var sentRows = 0;     // rows of the window handed to sendFrames
+  var sentTotal = 0;    // list length the watch was told
+  var sentFinal = false;  // ...and that it was the final one
+  var parsed = 0;       // characters of responseText consumed
+
+  var xhr = new XMLHttpRequest();
+  stream.xhr = xhr;
+  console.log('Streaming tasks from:', url);
+
+  // Encode the complete lines received so far (and the rest, once loaded)
+  function readLines(loaded) {
+    var text = xhr.responseText || '';
+    while (parsed < text.length) {
+      var end = text.indexOf('\n', parsed);
+      if (end === -1) {
+        if (!loaded) break;
+        end = text.length;
+      }
+      var line = text.substring(parsed, end);
+      parsed = end + 1;
+      if (!line.trim()) continue;
+
+      var entry = JSON.parse(line);
+      if (entry.type === 'task') {
+        records.push(encodeTasks([entry.task])[0]);
+      } else if (entry.type === 'end') {
+        version = entry.version || 0;
+        complete = true;
+      } else if (entry.type === 'error') {
+        throw new Error(entry.error);
+      }
+    }
+  }
+
+  function sent() {
+    sending = false;
+    sendRows();
+  }
+
+  // Send the list length: the rows known so far, or the final one with the version
+  function sendTotal() {
+    if (stream.cancelled) {
+      return;
+    }
+    var total = records.length;
+    var final = complete;
+    var dict = {};
+    dict[keys.KEY_TYPE] = 2;
+    dict[keys.KEY_TOTAL] = total;
+    dict[keys.KEY_GENERATION] = stream.generation;
+    if (final) {
+      dict[keys.KEY_VERSION] = version;
+    }
+    sending = true;
+    sendPaced(dict, function() {
+      sentTotal = total;
+      sentFinal = final;
+      console.log('Streamed list has ' + total + (final ? '' : ' or more') + ' tasks');
+      sent();
+    }, sendTotal);
+  }
+
+  // Send what the watch has not got yet: rows of the window, then the length
+  function sendRows() {
+    if (!opened || sending || stream.cancelled) {
+      return;
+    }
+    var windowEnd = Math.min(records.length, watchRows);
+    if (sentRows < windowEnd) {
+      var rows = records.slice(sentRows, windowEnd);
+      var positions = rows.map(function(record, i) { return sentRows + i; });
+      sentRows = windowEnd;
+      sending = true;
+      sendFrames('streamed tasks', packFrames(2, rows, positions).frames, stream, sent);
+    } else if (complete ? !sentFinal : records.length > Math.max(sentTotal, watchRows)) {
+      sendTotal();
+    }
+  }
+
+  // Open the list on the watch with the rows known so far
+  function sendFirstRows() {
+    if (opened || !watchRows || !records.length || complete) {
+      return;
+    }
+    opened = true;
+    sending = true;
+    console.log('Streaming tasks to the watch, ' + records.length + ' so far');
+    // Page requests are served from records as it grows
+    pagedTasks = { listId: listId, version: 0, records: records };
+    sentRows = Math.min(records.length, watchRows);
+    var countFields = {};
+    countFields[keys.KEY_VERSION] = 0;
+    countFields[keys.KEY_TOTAL] = 0;
+    sendFramesToWatch('tasks', 2, records.length, packFrames(2, records.slice(0, sentRows)), countFields, stream, sent);
+  }
+
+  xhr.onprogress = function() {
+    if (stream.cancelled || xhr.status !== 200) {
+      return;
+    }
+    try {
+      readLines(false);
+      sendFirstRows();
+      sendRows();
+    } catch (e) {
+      console.log('Error reading task stream:', e);
+    }
+  };
+  xhr.onload = function() {
+    stream.xhr = null;
+    if (stream.cancelled) {
+      return;
+    }
+    if (xhr.status !== 200) {
+      console.log('Failed to stream tasks. Status:', xhr.status);
+      return;
+    }
+    try {
+      readLines(true);
+    } catch (e) {
+      console.log('Error reading task stream:', e);
+      return;
+    }
+    if (!complete) {
+      console.log('Task stream ended early after ' + records.length + ' tasks');
+      return;
+    }
 
-// Helper function to format Date as ISO string in LOCAL timezone
-// Output format: "2026-02-15T14:30:00" (no Z suffix, represents local time)
-function formatDateAsLocalISO(date) {
-  var year = date.getFullYear();
-  var month = pad(date.getMonth() + 1);
-  var day = pad(date.getDate());
-  var hours = pad(date.getHours());
-  var minutes = pad(date.getMinutes());
-  var seconds = pad(date.getSeconds());
+    var update = { listId: listId, version: version, records: records };
+    saveTasksCache(update);
+    if (opened) {
+      pagedTasks.version = version;
+      sendRows();
+    } else {
+      sendTasksToWatch(update, null, 0, watchRows, stream);
+    }
+  };
+  xhr.open('GET', url, true);
+  xhr.send();
+}
 
-  console.log('formatDateAsLocalISO - Date object:', date.toString());
-  console.log('formatDateAsLocalISO - Year:', year, 'Month:', month, 'Day:', day);
-  console.log('formatDateAsLocalISO - Hours:', hours, 'Minutes:', minutes, 'Seconds:', seconds);
+// The last task records sent to the watch: {listId, version, records}
+function loadTasksCache() {
+  try {
+    return JSON.parse(localStorage.getItem(TASKS_CACHE_KEY));
+  } catch (e) {
+    return null;
+  }
+}
 
-  return year + '-' + month + '-' + day + 'T' + hours + ':' + minutes + ':' + seconds;
+function saveTasksCache(cache) {
+  try {
+    localStorage.setItem(TASKS_CACHE_KEY, JSON.stringify(cache));
+  } catch (e) {
+    console.log('Could not cache tasks:', e);
+  }
 }
 
 // Helper function to check if a date string is in ISO format
@@ -249,16 +883,9 @@ function parseAppleScriptDate(dateStr) {
     return null;
   }
 
-  console.log('parseAppleScriptDate - Parsed values:');
-  console.log('  Year:', year, 'Month:', monthName, '(' + month + ')', 'Day:', day);
-  console.log('  Hour:', hour, 'Minute:', minute, 'Second:', second, 'AM/PM:', ampm);
-
   // Create Date object (assuming local time from the device)
   var date = new Date(year, month, day, hour, minute, second);
 
-  console.log('parseAppleScriptDate - Created Date object:', date.toString());
-  console.log('parseAppleScriptDate - Date.getHours():', date.getHours());
-
   // Check if date is valid
   if (isNaN(date.getTime())) {
     return null;
@@ -267,36 +894,38 @@ function parseAppleScriptDate(dateStr) {
   return date;
 }
 
-// Helper function to convert any date format to ISO
-function convertDateToISO(dateStr) {
-  if (!dateStr || dateStr.trim() === '') {
-    console.log('No date provided');
-    return null;
+// Helper function to parse an ISO 8601 date. Strings without a zone
+// designator ("2026-02-15T14:30:00", "2026-02-15") are local time.
+function parseISODate(dateStr) {
+  if (/(Z|[+-]\d{2}:?\d{2})$/.test(dateStr)) {
+    return new Date(dateStr);
   }
+  var parts = dateStr.split(/[-T:.]/);
+  return new Date(parseInt(parts[0], 10), parseInt(parts[1], 10) - 1, parseInt(parts[2], 10),
+                  parseInt(parts[3] || 0, 10), parseInt(parts[4] || 0, 10), parseInt(parts[5] || 0, 10));
+}
 
-  // If already ISO format, return as is
-  if (isISOFormat(dateStr)) {
-    console.log('Date already in ISO format:', dateStr);
-    return dateStr;
+// Helper function to convert any date format to seconds since epoch, for
+// servers that send only dueDate (task-server-local sends dueEpoch)
+function convertDateToEpoch(dateStr) {
+  if (!dateStr || String(dateStr).trim() === '') {
+    return null;
   }
 
   try {
     var date = null;
 
-    // Try to parse as AppleScript format first
-    if (dateStr.indexOf(' at ') !== -1) {
+    if (isISOFormat(dateStr)) {
+      date = parseISODate(dateStr);
+    } else if (dateStr.indexOf(' at ') !== -1) {
+      // AppleScript format
       date = parseAppleScriptDate(dateStr);
-      if (date) {
-        // Send Unix timestamp (seconds since epoch) as a string
-        var timestamp = Math.floor(date.getTime() / 1000).toString();
-        console.log('Converted AppleScript date from "' + dateStr + '" to timestamp: ' + timestamp);
-        console.log('  (that represents: ' + date.toString() + ')');
-        return timestamp;
-      }
     }
 
     // Fallback to standard Date parser
-    date = new Date(dateStr);
+    if (!date) {
+      date = new Date(dateStr);
+    }
 
     // Check if date is valid
     if (isNaN(date.getTime())) {
@@ -304,85 +933,220 @@ function convertDateToISO(dateStr) {
       return null;
     }
 
-    // Send Unix timestamp (seconds since epoch) as a string
-    var timestamp = Math.floor(date.getTime() / 1000).toString();
-    console.log('Converted date from "' + dateStr + '" to timestamp: ' + timestamp);
-    console.log('  (that represents: ' + date.toString() + ')');
-    return timestamp;
+    return Math.floor(date.getTime() / 1000);
   } catch (e) {
-    console.log('Error converting date to ISO:', dateStr, e);
+    console.log('Error converting date:', dateStr, e);
     return null;
   }
 }
 
-// Send tasks to the watch sequentially with delays to avoid APP_MSG_BUSY
-function sendTasksToWatch(tasks) {
-  var taskCount = (tasks && tasks.length) ? tasks.length : 0;
+// Encode tasks as binary records in list order
+function encodeTasks(tasks) {
+  return tasks.map(function(task) {
+    var due = task.dueEpoch !== undefined ? task.dueEpoch :
+              (task.dueDate ? convertDateToEpoch(task.dueDate) : null);
+    if (task.dueDate && due === null) {
+      console.log('Failed to convert date for task:', task.name, 'Original date:', task.dueDate);
+    }
 
-  // Send tasks one at a time with delay to avoid APP_MSG_BUSY
-  var currentIndex = 0;
-  var retryDelay = 500;
+    var flags = (task.completed ? RECORD_FLAG_COMPLETED : 0) |
+                (task.allDay && due ? RECORD_FLAG_ALL_DAY : 0) |
+                (priorityLevel(task) << RECORD_FLAG_PRIORITY_SHIFT);
+    return encodeRecord(flags, due, task.id || '', task.name || '', MAX_TASK_NAME_BYTES);
+  });
+}
 
-  function sendNextTask() {
-    if (currentIndex >= taskCount) {
-      console.log('All tasks sent successfully');
-      return;
+// Describe update's rows as runs over base's rows (see KEY_LAYOUT in
+// task_manager.h). Identical records are reused; anything else is a new row.
+// Returns the layout bytes and the new rows' positions, or null if the layout
+// does not fit in the count message.
+function diffLayout(base, update) {
+  var oldRows = {};
+  for (var j = 0; j < base.records.length; j++) {
+    var key = base.records[j].join(',');
+    (oldRows[key] = oldRows[key] || []).push(j);
+  }
+
+  var runs = [];
+  var newRows = [];
+  for (var i = 0; i < update.records.length; i++) {
+    var candidates = oldRows[update.records[i].join(',')];
+    var from = candidates && candidates.length ? candidates.shift() : LAYOUT_NEW_ROWS;
+    if (from === LAYOUT_NEW_ROWS) {
+      newRows.push(i);
     }
 
-    var task = tasks[currentIndex];
+    var last = runs[runs.length - 1];
+    if (last && (from === LAYOUT_NEW_ROWS ? last.from === LAYOUT_NEW_ROWS :
+                 last.from !== LAYOUT_NEW_ROWS && last.from + last.length === from)) {
+      last.length++;
+    } else {
+      runs.push({ from: from, length: 1 });
+    }
+  }
 
-    // Convert date to ISO format if present, otherwise use "No due date"
-    var dueDate = 'No due date';
-    if (task.dueDate) {
-      var convertedDate = convertDateToISO(task.dueDate);
-      if (convertedDate) {
-        dueDate = convertedDate;
-      } else {
-        console.log('Failed to convert date for task:', task.name, 'Original date:', task.dueDate);
-        dueDate = 'No due date';
-      }
+  var layout = [];
+  runs.forEach(function(run) {
+    layout.push(run.from & 0xff, run.from >>> 8, run.length & 0xff, run.length >>> 8);
+  });
+  if (DICT_HEADER_SIZE + 5 * (TUPLE_HEADER_SIZE + 4) + TUPLE_HEADER_SIZE + layout.length > watchInboxSize) {
+    return null;
+  }
+  return { layout: layout, newRows: newRows };
+}
+
+// Send a task list to the watch. If the watch holds base (same list and
+// version) only the changed rows are sent; otherwise the whole list, or just
+// its first watchRows rows when the watch pages it.
+function sendTasksToWatch(update, base, watchVersion, watchRows, stream) {
+  pagedTasks = update;
+  var countFields = {};
+  countFields[keys.KEY_VERSION] = update.version;
+
+  if (watchRows && update.records.length > watchRows) {
+    console.log('Paging ' + update.records.length + ' tasks, sending the first ' + watchRows);
+    sendFramesToWatch('tasks', 2, update.records.length, packFrames(2, update.records.slice(0, watchRows)), countFields, stream);
+    return;
+  }
+
+  var delta = null;
+  if (base && watchVersion && base.version === watchVersion && update.version && update.records.length > 0) {
+    delta = diffLayout(base, update);
+  }
+
+  if (delta) {
+    console.log('Sending tasks as delta: ' + delta.newRows.length + ' of ' + update.records.length + ' rows changed');
+    var records = delta.newRows.map(function(row) { return update.records[row]; });
+    countFields[keys.KEY_LAYOUT] = delta.layout;
+    sendFramesToWatch('tasks', 2, update.records.length, packFrames(2, records, delta.newRows), countFields, stream);
+  } else {
+    sendFramesToWatch('tasks', 2, update.records.length, packFrames(2, update.records), countFields, stream);
+  }
+}
+
+// Send rows [first, first + count) of the task list the watch is paging
+// through, as part of the task stream it was requested for. A newer page
+// request asks for every row still missing, so it stops the page being sent.
+function sendTaskPage(listId, first, count, generation) {
+  var stream = streams[2];
+  if (!pagedTasks || pagedTasks.listId !== listId || !stream || stream.generation !== generation) {
+    console.log('No tasks held for list', listId, 'stream', generation);
+    return;
+  }
+
+  var records = pagedTasks.records.slice(first, first + count);
+  var positions = records.map(function(record, i) { return first + i; });
+  if (stream.page) {
+    stream.page.cancelled = true;
+  }
+  var page = { type: 2, generation: stream.generation, cancelled: false };
+  stream.page = page;
+  sendFrames('task page', packFrames(2, records, positions).frames, page, function() {
+    if (stream.page === page) {
+      stream.page = null;
     }
-    var maxLength = 255; // Max length for notes
-    task.notes = task.notes.slice(0, maxLength);
+  });
+}
 
-    var dict = {
-      'KEY_TYPE': 2,
-      'KEY_ID': task.id || '',
-      'KEY_NAME': task.name || '',
-      'KEY_DUE_DATE': dueDate,
-      'KEY_COMPLETED': task.completed ? 1 : 0,
-      'KEY_NOTES': task.notes || ''
+function readUint32(bytes, offset) {
+  return (bytes[offset] | (bytes[offset + 1] << 8) | (bytes[offset + 2] << 16)) + bytes[offset + 3] * 0x1000000;
+}
+
+// Collect a trace dumped by the watch; once all entries arrived, or no chunk
+// came for TRACE_TIMEOUT_MS, post it to the server as JSON
+function receiveTraceChunk(first, count, bytes) {
+  if (first === 0 || traceCount === 0) {
+    traceEntries = [];
+    traceCount = count;
+    traceReceived = 0;
+  }
+  for (var i = 0; i + TRACE_ENTRY_SIZE <= bytes.length; i += TRACE_ENTRY_SIZE) {
+    var index = first + i / TRACE_ENTRY_SIZE;
+    if (!traceEntries[index]) {
+      traceReceived++;
+    }
+    traceEntries[index] = {
+      timeMs: readUint32(bytes, i),
+      event: TRACE_EVENTS[bytes[i + 4]] || bytes[i + 4],
+      arg: readUint32(bytes, i + 5)
     };
+  }
 
-    Pebble.sendAppMessage(dict,
-      function(e) {
-        console.log('Task ' + (currentIndex + 1) + '/' + taskCount + ' sent successfully');
-        retryDelay = 500;
-        currentIndex++;
-        setTimeout(sendNextTask, 200);
-      },
-      function(e) {
-        console.log('Error sending task ' + (currentIndex + 1) + ', retrying in ' + retryDelay + 'ms');
-        setTimeout(sendNextTask, retryDelay);
-        retryDelay = Math.min(retryDelay * 2, 4000);
-      }
-    );
+  clearTimeout(traceTimer);
+  if (traceReceived < traceCount) {
+    traceTimer = setTimeout(postTrace, TRACE_TIMEOUT_MS);
+    return;
   }
+  postTrace();
+}
 
-  // Send count first so the watch can allocate memory
-  var countDict = { 'KEY_TYPE': 2, 'KEY_COUNT': taskCount };
-  Pebble.sendAppMessage(countDict,
-    function(e) {
-      console.log('Tasks count (' + taskCount + ') sent, now sending items...');
-      if (taskCount > 0) {
-        setTimeout(sendNextTask, 200);
+// Post the trace received so far; each run of entries that never arrived
+// becomes one {event: 'gap', first, count} entry
+function postTrace() {
+  clearTimeout(traceTimer);
+  traceTimer = null;
+  var entries = [];
+  for (var i = 0; i < traceCount; i++) {
+    if (traceEntries[i]) {
+      entries.push(traceEntries[i]);
+    } else if (entries.length && entries[entries.length - 1].event === 'gap') {
+      entries[entries.length - 1].count++;
+    } else {
+      entries.push({ event: 'gap', first: i, count: 1 });
+    }
+  }
+
+  var watch = Pebble.getActiveWatchInfo ? Pebble.getActiveWatchInfo() : null;
+  var trace = {
+    platform: watch ? watch.platform : 'unknown',
+    inboxSize: watchInboxSize,
+    missing: traceCount - traceReceived,
+    entries: entries
+  };
+  traceEntries = [];
+  traceCount = 0;
+  traceReceived = 0;
+  if (trace.missing) {
+    console.log('Trace incomplete: ' + trace.missing + ' entries missing');
+  }
+
+  var xhr = new XMLHttpRequest();
+  xhr.open('POST', API_BASE + '/trace', true);
+  xhr.setRequestHeader('Content-Type', 'application/json');
+  xhr.onload = function() {
+    console.log('Posted ' + trace.entries.length + ' trace entries. Status:', xhr.status);
+  };
+  xhr.send(JSON.stringify(trace));
+}
+
+// Fetch the notes of a single task (notes are not part of the list stream)
+function fetchTaskNotes(listId, taskId) {
+  var xhr = new XMLHttpRequest();
+  var url = API_BASE + '/lists/' + encodeURIComponent(listId) + '/tasks/' + encodeURIComponent(taskId) + '?' + 'provider=' + provider;
+  xhr.open('GET', url, true);
+  xhr.onload = function() {
+    if (xhr.readyState === 4) {
+      var notes = '';
+      if (xhr.status === 200) {
+        try {
+          var task = JSON.parse(xhr.responseText).task || {};
+          notes = task.notes || task.body || '';
+        } catch (e) {
+          console.log('Error parsing response:', e);
+        }
+      } else {
+        console.log('Failed to fetch task notes. Status:', xhr.status);
       }
-    },
-    function(e) {
-      console.log('Error sending tasks count, retrying...');
-      setTimeout(function() { sendTasksToWatch(tasks); }, 500);
+
+      // Always reply so the watch stops showing "Loading..."
+      sendRetried('task notes', {
+        'KEY_TYPE': 5,
+        'KEY_ID': taskId,
+        'KEY_NOTES': truncateUtf8(String(notes), MAX_NOTES_BYTES)
+      }, 1);
     }
-  );
+  };
+  xhr.send();
 }
 
 // Complete a task
@@ -402,7 +1166,7 @@ function completeTask(taskId, listName) {
           'KEY_TYPE': 4,
           'KEY_ID': taskId
         };
-        Pebble.sendAppMessage(dict);
+        sendAppMessage(dict);
       } else {
         console.log('Failed to complete task. Status: ' + xhr.status);
       }
@@ -426,7 +1190,8 @@ Pebble.addEventListener('showConfiguration', function(e) {
     '?v=' + Date.now() +
     '&hostname=' + encodeURIComponent(currentHostname) +
     '&port=' + encodeURIComponent(currentPort) +
-    '&provider=' + encodeURIComponent(currentProvider);
+    '&provider=' + encodeURIComponent(currentProvider) +
+    '&record=' + (recordMessages ? 'true' : 'false');
 
   console.log('Config URL:', configUrl);
   Pebble.openURL(configUrl);
@@ -458,6 +1223,12 @@ Pebble.addEventListener('webviewclosed', function(e) {
         console.log('Saved provider:', config.provider);
       }
 
+      if (config.recordMessages !== undefined) {
+        recordMessages = !!config.recordMessages;
+        localStorage.setItem('record_messages', recordMessages ? 'true' : 'false');
+        console.log('Recording messages:', recordMessages);
+      }
+
       // Update API base URL
       updateAPIBase();
       console.log('Configuration saved successfully');
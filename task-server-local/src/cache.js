@@ -0,0 +1,318 @@
+/**
+ * In-memory cache of what the providers return, so that repeated watch
+ * requests are answered without a provider call. Entries are kept per scope
+ * (provider and credentials, see server.js) and per list and query:
+ *
+ *   lists   the provider's task lists, for listsTtlMs
+ *   tasks   the tasks of one list for one query, for tasksTtlMs, with an
+ *           id -> task index for single task lookups
+ *
+ * A write to a list invalidates every cached query of it. Entries used
+ * within recentMs are reloaded in the background shortly before they expire
+ * (refresh-ahead), so lists in use keep being served from memory. A TTL of 0
+ * turns caching of that kind off.
+ *
+ * Loads are called as load(signal) on a miss and load(undefined, true) to
+ * refresh. Misses go through a SingleFlight keyed like the entries (scope,
+ * kind, list, query), so identical reads that miss together make one
+ * provider call. Streamed reads (streamTasks) take part too: callers that
+ * join one get the pages already produced, then the rest as they arrive.
+ */
+
+const { SingleFlight } = require('./singleflight');
+
+const DEFAULTS = {
+  listsTtlMs: 5 * 60 * 1000,
+  tasksTtlMs: 30 * 1000,
+  recentMs: 10 * 60 * 1000,
+  refreshIntervalMs: 5000
+};
+
+// Refresh-ahead reloads an entry once this share of its TTL has passed
+const REFRESH_AT = 0.8;
+
+class TaskCache {
+  constructor(options = {}) {
+    this.options = Object.assign({}, DEFAULTS);
+    for (const name of Object.keys(options)) {
+      if (options[name] !== undefined) {
+        this.options[name] = options[name];
+      }
+    }
+    this.entries = new Map();      // key -> entry
+    this.invalidated = new Map();  // provider + list -> sequence number of the last write
+    this.sequence = 0;
+    this.timer = null;
+    this.flights = new SingleFlight();
+    this.streams = new Map();      // key -> StreamedLoad of a streamed read in flight
+    this.stats = {
+      lists: { hits: 0, misses: 0 },
+      tasks: { hits: 0, misses: 0 },
+      task: { hits: 0, misses: 0 },
+      refreshes: 0,
+      refreshErrors: 0,
+      invalidations: 0
+    };
+  }
+
+  // The lists of a scope, from the cache or load(signal)
+  lists(scope, load, signal) {
+    return this.get('lists', scope, null, '', this.options.listsTtlMs, load, signal);
+  }
+
+  // The tasks of a list for one query (optionsKey), from the cache or load(signal)
+  tasks(scope, listId, optionsKey, load, signal) {
+    return this.get('tasks', scope, listId, optionsKey, this.options.tasksTtlMs, load, signal);
+  }
+
+  // Cached tasks of a list for one query, or null (counted as a miss)
+  peekTasks(scope, listId, optionsKey) {
+    const entry = this.fresh(this.key('tasks', scope, listId, optionsKey));
+    this.count('tasks', entry);
+    return entry ? entry.value : null;
+  }
+
+  // Pages of the tasks of a list for one query, read with pages(signal) (an
+  // async iterable of task arrays) and cached once complete. Joins a read of
+  // the same list and query in flight, streamed or not, instead of starting
+  // another; the caller checks the cache first (peekTasks).
+  async *streamTasks(scope, listId, optionsKey, pages, load, signal) {
+    const key = this.key('tasks', scope, listId, optionsKey);
+    let stream = null;
+    let done;
+    if (this.flights.pending(key)) {
+      stream = this.streams.get(key) || null;
+      done = this.flights.run(key, null, signal);
+    } else {
+      stream = new StreamedLoad();
+      this.streams.set(key, stream);
+      done = this.flights.run(key, async flightSignal => {
+        const ticket = this.ticket();
+        try {
+          for await (const page of pages(flightSignal)) {
+            stream.push(page);
+          }
+          const value = [].concat(...stream.pages);
+          this.store('tasks', scope, listId, optionsKey, this.options.tasksTtlMs, value, load, ticket);
+          return value;
+        } finally {
+          stream.finish();
+          if (this.streams.get(key) === stream) {
+            this.streams.delete(key);
+          }
+        }
+      }, signal);
+    }
+
+    if (!stream) {
+      // A plain read is in flight: all in one go
+      yield await done;
+      return;
+    }
+    yield* stream.read(done);
+  }
+
+  // A task of a list from the cache, or load(signal) (not cached itself)
+  async task(scope, listId, taskId, load, signal) {
+    const task = this.findTask(scope, listId, taskId);
+    if (task) {
+      return task;
+    }
+    return this.flights.run(this.key('task', scope, listId, taskId), load, signal);
+  }
+
+  // A task of a list from any fresh cached query of it, or null
+  findTask(scope, listId, taskId) {
+    for (const entry of this.entries.values()) {
+      if (entry.kind === 'tasks' && entry.scope === scope && entry.listId === listId &&
+          this.isFresh(entry) && entry.byId.has(taskId)) {
+        entry.usedAt = Date.now();
+        this.stats.task.hits++;
+        return entry.byId.get(taskId);
+      }
+    }
+    this.stats.task.misses++;
+    return null;
+  }
+
+  // Drop every cached query of a list of a provider, in all scopes, and keep
+  // loads that started before from being cached
+  invalidate(providerName, listId) {
+    this.stats.invalidations++;
+    this.invalidated.set(`${providerName}\n${listId}`, ++this.sequence);
+    for (const [key, entry] of this.entries) {
+      if (entry.kind === 'tasks' && entry.listId === listId && providerOf(entry.scope) === providerName) {
+        this.entries.delete(key);
+      }
+    }
+  }
+
+  ticket() {
+    return ++this.sequence;
+  }
+
+  startRefreshAhead() {
+    if (!this.timer) {
+      this.timer = setInterval(() => this.refreshAhead(), this.options.refreshIntervalMs);
+      this.timer.unref();
+    }
+  }
+
+  stop() {
+    clearInterval(this.timer);
+    this.timer = null;
+  }
+
+  // Counters and the number of cached entries, for tuning the TTLs
+  snapshot() {
+    const hitRate = counter => {
+      const total = counter.hits + counter.misses;
+      return Object.assign({ hitRate: total ? counter.hits / total : null }, counter);
+    };
+    return {
+      options: this.options,
+      entries: this.entries.size,
+      lists: hitRate(this.stats.lists),
+      tasks: hitRate(this.stats.tasks),
+      task: hitRate(this.stats.task),
+      refreshes: this.stats.refreshes,
+      refreshErrors: this.stats.refreshErrors,
+      invalidations: this.stats.invalidations,
+      // Provider calls made for misses, and misses that joined one in flight
+      providerCalls: this.flights.stats.calls,
+      sharedCalls: this.flights.stats.shared
+    };
+  }
+
+  async get(kind, scope, listId, optionsKey, ttlMs, load, signal) {
+    const key = this.key(kind, scope, listId, optionsKey);
+    const entry = this.fresh(key);
+    this.count(kind, entry);
+    if (entry) {
+      return entry.value;
+    }
+    return this.flights.run(key, async flightSignal => {
+      const ticket = this.ticket();
+      const value = await load(flightSignal);
+      this.store(kind, scope, listId, optionsKey, ttlMs, value, load, ticket);
+      return value;
+    }, signal);
+  }
+
+  store(kind, scope, listId, optionsKey, ttlMs, value, load, ticket) {
+    if (!ttlMs || (listId !== null && ticket <= (this.invalidated.get(`${providerOf(scope)}\n${listId}`) || 0))) {
+      return;
+    }
+    const key = this.key(kind, scope, listId, optionsKey);
+    const previous = this.entries.get(key);
+    const now = Date.now();
+    this.entries.set(key, {
+      kind, scope, listId, optionsKey, value, load, ttlMs,
+      byId: kind === 'tasks' ? new Map(value.map(task => [task.id, task])) : null,
+      fetchedAt: now,
+      usedAt: previous ? previous.usedAt : now,
+      refreshing: false
+    });
+  }
+
+  refreshAhead() {
+    const now = Date.now();
+    for (const [key, entry] of this.entries) {
+      const recent = now - entry.usedAt <= this.options.recentMs;
+      if (!recent && !this.isFresh(entry)) {
+        this.entries.delete(key);
+      } else if (recent && !entry.refreshing && now - entry.fetchedAt >= entry.ttlMs * REFRESH_AT) {
+        this.refresh(entry);
+      }
+    }
+  }
+
+  refresh(entry) {
+    const key = this.key(entry.kind, entry.scope, entry.listId, entry.optionsKey);
+    entry.refreshing = true;
+    this.stats.refreshes++;
+    this.flights.run(key, async () => {
+      const ticket = this.ticket();
+      const value = await entry.load(undefined, true);
+      if (this.entries.get(key) === entry) {
+        this.store(entry.kind, entry.scope, entry.listId, entry.optionsKey, entry.ttlMs, value, entry.load, ticket);
+      }
+      return value;
+    }).catch(error => {
+      this.stats.refreshErrors++;
+      console.log(`Cache refresh of ${entry.kind} ${entry.listId || ''} failed: ${error.message}`);
+    }).finally(() => {
+      entry.refreshing = false;
+    });
+  }
+
+  key(kind, scope, listId, optionsKey) {
+    return [kind, scope, listId || '', optionsKey].join('\n');
+  }
+
+  fresh(key) {
+    const entry = this.entries.get(key);
+    if (!entry || !this.isFresh(entry)) {
+      return null;
+    }
+    entry.usedAt = Date.now();
+    return entry;
+  }
+
+  isFresh(entry) {
+    return Date.now() - entry.fetchedAt < entry.ttlMs;
+  }
+
+  count(kind, entry) {
+    this.stats[kind][entry ? 'hits' : 'misses']++;
+  }
+}
+
+// Pages of a streamed read as they arrive, for every caller that joined it
+class StreamedLoad {
+  constructor() {
+    this.pages = [];
+    this.finished = false;
+    this.wake = null;
+    this.changed = new Promise(resolve => { this.wake = resolve; });
+  }
+
+  push(page) {
+    this.pages.push(page);
+    this.notify();
+  }
+
+  finish() {
+    this.finished = true;
+    this.notify();
+  }
+
+  notify() {
+    this.wake();
+    this.changed = new Promise(resolve => { this.wake = resolve; });
+  }
+
+  // Every page from the first; done is the caller's wait on the shared read,
+  // which rejects when the read fails or the caller aborts
+  async *read(done) {
+    done.catch(() => {});
+    let next = 0;
+    while (true) {
+      while (next < this.pages.length) {
+        yield this.pages[next++];
+      }
+      if (this.finished) {
+        await done;  // throws if the read failed
+        return;
+      }
+      await Promise.race([this.changed, done]);
+    }
+  }
+}
+
+// Scopes start with the provider name (see cacheScope in server.js)
+function providerOf(scope) {
+  return scope.split(':')[0];
+}
+
+module.exports = { TaskCache };
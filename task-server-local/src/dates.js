@@ -0,0 +1,85 @@
+/**
+ * Due dates, normalized once on the server so neither the phone nor the watch
+ * parses date strings. Providers add to each task:
+ *   dueEpoch  seconds since the epoch, or null without a due date
+ *   allDay    true when the task is due on a day rather than at a time
+ * An all-day due date is the start of its day. Providers give it as midnight
+ * on the server; forClient() moves it to the client's midnight of that day.
+ */
+
+const MONTHS = {
+  January: 0, February: 1, March: 2, April: 3, May: 4, June: 5,
+  July: 6, August: 7, September: 8, October: 9, November: 10, December: 11
+};
+
+const NO_DUE = { dueEpoch: null, allDay: false };
+
+function toEpoch(date) {
+  const time = date.getTime();
+  return Number.isNaN(time) ? null : Math.floor(time / 1000);
+}
+
+function startOfDay(year, month, day) {
+  return toEpoch(new Date(year, month, day));
+}
+
+// AppleScript `date as string`, in the server's time zone:
+// "Saturday, January 17, 2026 at 12:00:00 AM"
+function parseAppleScriptDate(str) {
+  const match = /\w+,\s+(\w+)\s+(\d+),\s+(\d+)\s+at\s+(\d+):(\d+):(\d+)\s+(AM|PM)/.exec(str);
+  if (!match || MONTHS[match[1]] === undefined) {
+    return new Date(str);
+  }
+  let hour = parseInt(match[4], 10) % 12;
+  if (match[7] === 'PM') hour += 12;
+  return new Date(parseInt(match[3], 10), MONTHS[match[1]], parseInt(match[2], 10),
+                  hour, parseInt(match[5], 10), parseInt(match[6], 10));
+}
+
+// Apple Reminders: the due date string, and whether the reminder has an
+// all-day due date
+function fromAppleScript(str, allDay) {
+  if (!str) return NO_DUE;
+  const date = parseAppleScriptDate(str);
+  const dueEpoch = allDay ? startOfDay(date.getFullYear(), date.getMonth(), date.getDate()) : toEpoch(date);
+  return dueEpoch === null ? NO_DUE : { dueEpoch, allDay: Boolean(allDay) };
+}
+
+// An ISO 8601 instant (reminders-cli). Reminders due on a day without a time
+// come out as local midnight, so midnight is taken as all day.
+function fromInstant(str) {
+  if (!str) return NO_DUE;
+  const date = new Date(str);
+  const dueEpoch = toEpoch(date);
+  if (dueEpoch === null) return NO_DUE;
+  const allDay = date.getHours() === 0 && date.getMinutes() === 0 && date.getSeconds() === 0;
+  return { dueEpoch, allDay };
+}
+
+// A due day sent as a timestamp whose time part means nothing (Google's RFC
+// 3339 `due`, Microsoft's `dueDateTime.dateTime`): only the date counts
+function fromDatePart(str) {
+  const match = /^(\d{4})-(\d{2})-(\d{2})/.exec(str || '');
+  if (!match) return NO_DUE;
+  const dueEpoch = startOfDay(parseInt(match[1], 10), parseInt(match[2], 10) - 1, parseInt(match[3], 10));
+  return dueEpoch === null ? NO_DUE : { dueEpoch, allDay: true };
+}
+
+// Move all-day due dates to midnight in the client's time zone, given as its
+// Date.getTimezoneOffset() (minutes, UTC minus local). Without it they stay at
+// the server's midnight.
+function forClient(tasks, tzOffset) {
+  if (!Number.isFinite(tzOffset)) {
+    return tasks;
+  }
+  return tasks.map(task => {
+    if (!task.allDay || task.dueEpoch === null || task.dueEpoch === undefined) {
+      return task;
+    }
+    const day = new Date(task.dueEpoch * 1000);
+    const dueEpoch = Date.UTC(day.getFullYear(), day.getMonth(), day.getDate()) / 1000 + tzOffset * 60;
+    return Object.assign({}, task, { dueEpoch });
+  });
+}
+
+module.exports = { fromAppleScript, fromInstant, fromDatePart, forClient };
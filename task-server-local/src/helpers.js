@@ -0,0 +1,164 @@
+/**
+ * Resident helper processes for the CLI-backed providers. Instead of a new
+ * process per call, a small pool of long-running helpers takes commands as
+ * newline-delimited JSON on stdin and answers on stdout:
+ *
+ *   -> {"id": 1, ...command}
+ *   <- {"id": 1, "output": "..."}   or   {"id": 1, "error": "..."}
+ *
+ * A helper answers its commands in order, one at a time. One that exits is
+ * started again on its next command; one that does not answer in time is
+ * killed, since whatever it is stuck on holds up everything queued behind it.
+ */
+
+const { spawn } = require('child_process');
+const readline = require('readline');
+
+const DEFAULT_TIMEOUT_MS = 60000;
+
+// Requests go out as pure ASCII so that a helper may split its input into
+// lines before decoding it
+function toAsciiJson(value) {
+  return JSON.stringify(value).replace(/[\u007f-\uffff]/g,
+    c => '\\u' + c.charCodeAt(0).toString(16).padStart(4, '0'));
+}
+
+class HelperPool {
+  // command and args start one helper; options: size (helpers, default 1),
+  // timeoutMs (per command), name (for errors and logs)
+  constructor(command, args = [], options = {}) {
+    this.command = command;
+    this.args = args;
+    this.size = Math.max(1, options.size || 1);
+    this.timeoutMs = options.timeoutMs || DEFAULT_TIMEOUT_MS;
+    this.name = options.name || command;
+    this.workers = [];
+    this.nextId = 1;
+    this.stats = { calls: 0, starts: 0, crashes: 0, timeouts: 0 };
+  }
+
+  // Send a command to the least busy helper and resolve with its output.
+  // Rejects with error.helperFailed if the helper died or could not start,
+  // error.timedOut after timeoutMs, or error.aborted once signal aborts; an
+  // aborted command still runs to completion in the helper.
+  call(command, options = {}) {
+    const signal = options.signal;
+    if (signal && signal.aborted) {
+      return Promise.reject(Object.assign(new Error('Aborted'), { aborted: true }));
+    }
+
+    const worker = this.pickWorker();
+    const id = this.nextId++;
+    const timeoutMs = options.timeoutMs || this.timeoutMs;
+    this.stats.calls++;
+
+    return new Promise((resolve, reject) => {
+      const pending = { resolve, reject, timer: null, signal, onAbort: null };
+      pending.timer = setTimeout(() => {
+        this.stats.timeouts++;
+        this.settle(worker, id, Object.assign(new Error(`${this.name} timed out after ${timeoutMs / 1000} seconds`),
+                                              { timedOut: true }));
+        this.stop(worker, `${this.name} helper stopped after a timeout`);
+      }, timeoutMs);
+      if (signal) {
+        pending.onAbort = () => this.settle(worker, id, Object.assign(new Error('Aborted'), { aborted: true }));
+        signal.addEventListener('abort', pending.onAbort);
+      }
+      worker.pending.set(id, pending);
+      worker.inFlight.add(id);
+      worker.child.stdin.write(toAsciiJson(Object.assign({}, command, { id })) + '\n');
+    });
+  }
+
+  // Stop all helpers; commands still waiting fail
+  close() {
+    for (const worker of this.workers.slice()) {
+      this.stop(worker, `${this.name} helper pool closed`);
+    }
+  }
+
+  pickWorker() {
+    let best = null;
+    for (const worker of this.workers) {
+      if (!best || worker.inFlight.size < best.inFlight.size) {
+        best = worker;
+      }
+    }
+    if (best && (best.inFlight.size === 0 || this.workers.length >= this.size)) {
+      return best;
+    }
+    return this.start();
+  }
+
+  start() {
+    const child = spawn(this.command, this.args, { stdio: ['pipe', 'pipe', 'pipe'] });
+    // pending: callers by command id; inFlight: ids the helper has yet to
+    // answer, including aborted ones
+    const worker = { child, pending: new Map(), inFlight: new Set(), stderr: '' };
+    this.workers.push(worker);
+    this.stats.starts++;
+
+    readline.createInterface({ input: child.stdout }).on('line', line => {
+      let reply;
+      try {
+        reply = JSON.parse(line);
+      } catch (e) {
+        console.log(`${this.name} helper: ignoring output line ${line.slice(0, 80)}`);
+        return;
+      }
+      worker.inFlight.delete(reply.id);
+      if (reply.error !== undefined) {
+        this.settle(worker, reply.id, new Error(reply.error));
+      } else {
+        this.settle(worker, reply.id, null, reply.output === undefined ? '' : String(reply.output));
+      }
+    });
+    // Keep the last of stderr to explain a crash
+    child.stderr.on('data', chunk => {
+      worker.stderr = (worker.stderr + chunk.toString('utf-8')).slice(-1000);
+    });
+    child.stdin.on('error', () => {});  // EPIPE from a dead helper; 'exit' reports it
+
+    child.on('error', error => this.stop(worker, `${this.name} helper failed to start: ${error.message}`));
+    child.on('exit', (code, signal) => {
+      if (this.workers.includes(worker)) {
+        this.stats.crashes++;
+        const reason = worker.stderr.trim() || (signal ? `signal ${signal}` : `exit code ${code}`);
+        console.log(`${this.name} helper exited (${reason}); restarting on next use`);
+        this.stop(worker, `${this.name} helper exited: ${reason}`);
+      }
+    });
+    return worker;
+  }
+
+  // Take a helper out of the pool, kill it, and fail its commands
+  stop(worker, message) {
+    const i = this.workers.indexOf(worker);
+    if (i >= 0) {
+      this.workers.splice(i, 1);
+    }
+    for (const id of Array.from(worker.pending.keys())) {
+      this.settle(worker, id, Object.assign(new Error(message), { helperFailed: true }));
+    }
+    worker.child.kill();
+  }
+
+  settle(worker, id, error, output) {
+    const pending = worker.pending.get(id);
+    if (!pending) {
+      return;  // aborted, or a reply to a command it already timed out on
+    }
+    worker.pending.delete(id);
+    clearTimeout(pending.timer);
+    if (pending.signal) {
+      pending.signal.removeEventListener('abort', pending.onAbort);
+    }
+    if (error) {
+      pending.reject(error);
+    } else {
+      pending.resolve(output);
+    }
+  }
+}
+
+module.exports = { HelperPool };
@@ -0,0 +1,88 @@
+/**
+ * Child processes for the CLI-backed providers (reminders-cli, osascript).
+ * They run asynchronously, so a slow call holds up only the request waiting
+ * for it, not the event loop and every other request behind it.
+ */
+
+const { spawn } = require('child_process');
+
+const DEFAULT_TIMEOUT_MS = 60000;
+const DEFAULT_MAX_BUFFER = 10 * 1024 * 1024;
+
+// Run a command without a shell and resolve with its trimmed stdout. Rejects
+// if it exits non-zero, outputs more than maxBuffer bytes, runs longer than
+// timeoutMs (error.timedOut), or signal aborts first (error.aborted); in all
+// of these the process is killed.
+function runProcess(command, args, options = {}) {
+  const timeoutMs = options.timeoutMs || DEFAULT_TIMEOUT_MS;
+  const maxBuffer = options.maxBuffer || DEFAULT_MAX_BUFFER;
+  const signal = options.signal;
+
+  return new Promise((resolve, reject) => {
+    if (signal && signal.aborted) {
+      reject(Object.assign(new Error('Aborted'), { aborted: true }));
+      return;
+    }
+
+    const child = spawn(command, args, { stdio: ['ignore', 'pipe', 'pipe'] });
+    const stdout = [];
+    const stderr = [];
+    let size = 0;
+    let settled = false;
+
+    function settle() {
+      settled = true;
+      clearTimeout(timer);
+      if (signal) {
+        signal.removeEventListener('abort', onAbort);
+      }
+    }
+
+    // Reject right away rather than on close: a killed script's own children
+    // can hold its output open until they finish
+    function fail(error) {
+      if (!settled) {
+        settle();
+        child.kill();
+        reject(error);
+      }
+    }
+
+    function onAbort() {
+      fail(Object.assign(new Error('Aborted'), { aborted: true }));
+    }
+
+    const timer = setTimeout(() => {
+      fail(Object.assign(new Error(`Timed out after ${timeoutMs / 1000} seconds`), { timedOut: true }));
+    }, timeoutMs);
+    if (signal) {
+      signal.addEventListener('abort', onAbort);
+    }
+
+    child.stdout.on('data', chunk => {
+      size += chunk.length;
+      if (size > maxBuffer) {
+        fail(new Error(`Output exceeds ${maxBuffer} bytes`));
+      } else {
+        stdout.push(chunk);
+      }
+    });
+    child.stderr.on('data', chunk => stderr.push(chunk));
+
+    child.on('error', fail);
+    child.on('close', code => {
+      if (settled) {
+        return;
+      }
+      settle();
+      if (code !== 0) {
+        const message = Buffer.concat(stderr).toString('utf-8').trim();
+        reject(Object.assign(new Error(`Exit code ${code}${message ? `: ${message}` : ''}`), { code }));
+      } else {
+        resolve(Buffer.concat(stdout).toString('utf-8').trim());
+      }
+    });
+  });
+}
+
+module.exports = { runProcess };
@@ -1,29 +1,49 @@
-const { execSync } = require('child_process');
+const path = require('path');
+const dates = require('../../dates');
+const { runProcess } = require('../../processes');
+const { HelperPool } = require('../../helpers');
 
 class AppleRemindersProvider {
-  constructor() {
+  constructor(config = {}) {
     this.name = 'Apple Reminders';
+    // 60 second timeout to handle large lists
+    this.timeoutMs = config.timeoutMs || 60000;
+    // Scripts run in resident osascript helpers (helper.js) unless
+    // config.helper is false
+    this.helpers = config.helper === false ? null :
+      new HelperPool('osascript', ['-l', 'JavaScript', path.join(__dirname, 'helper.js')], {
+        size: config.helpers || 2,
+        timeoutMs: this.timeoutMs,
+        name: 'AppleScript'
+      });
   }
 
-  // Execute AppleScript and return result
-  executeAppleScript(script) {
+  // Execute AppleScript and return result. signal (optional) abandons the
+  // script when the client that wanted the result is gone.
+  async executeAppleScript(script, signal) {
     try {
-      const result = execSync(`osascript -e '${script.replace(/'/g, "'\\''")}'`, {
-        encoding: 'utf-8',
-        maxBuffer: 10 * 1024 * 1024,
-        timeout: 60000 // 60 second timeout to handle large lists
-      });
-      return result.trim();
+      if (this.helpers) {
+        try {
+          return await this.helpers.call({ script }, { signal });
+        } catch (error) {
+          if (!error.helperFailed) {
+            throw error;
+          }
+          // Still answer this request, with an osascript of its own
+          console.log(`${error.message}; running the script with osascript`);
+        }
+      }
+      return await runProcess('osascript', ['-e', script], { timeoutMs: this.timeoutMs, signal });
     } catch (error) {
-      if (error.killed) {
-        throw new Error(`AppleScript timeout: Script took longer than 60 seconds to execute`);
+      if (error.timedOut) {
+        throw new Error(`AppleScript timeout: Script took longer than ${this.timeoutMs / 1000} seconds to execute`);
       }
       throw new Error(`AppleScript error: ${error.message}`);
     }
   }
 
   // Get all task lists
-  async getLists() {
+  async getLists(options = {}) {
     const script = `
       tell application "Reminders"
         set output to ""
@@ -37,15 +57,15 @@ class AppleRemindersProvider {
       end tell
     `;
     
-    const result = this.executeAppleScript(script);
+    const result = await this.executeAppleScript(script, options.signal);
     return this.parseListsOutput(result);
   }
 
   // Get tasks from a specific list
   async getTasks(listId, options = {}) {
-    // Default to showing only incomplete tasks, with a limit of 50
+    // Default to showing only incomplete tasks, with a limit of 50 (0: no limit)
     const showCompleted = options.showCompleted || false;
-    const limit = options.limit || 50;
+    const limit = options.limit === undefined ? 50 : options.limit;
 
     // Use 'whose' clause to filter reminders efficiently
     const filterClause = showCompleted ? '' : ' whose completed is false';
@@ -73,11 +93,14 @@ class AppleRemindersProvider {
                 if due date of aReminder is not missing value then
                   set output to output & "DUE:" & (due date of aReminder as string) & linefeed
                 end if
+                if allday due date of aReminder is not missing value then
+                  set output to output & "ALLDAY:true" & linefeed
+                end if
               end try
               set output to output & "TASK_END" & linefeed
 
               set taskCount to taskCount + 1
-              if taskCount >= maxTasks then
+              if maxTasks > 0 and taskCount >= maxTasks then
                 exit repeat
               end if
             end repeat
@@ -88,12 +111,12 @@ class AppleRemindersProvider {
       end tell
     `;
 
-    const result = this.executeAppleScript(script);
+    const result = await this.executeAppleScript(script, options.signal);
     return this.parseTasksOutput(result);
   }
 
   // Get task details
-  async getTask(listId, taskId) {
+  async getTask(listId, taskId, options = {}) {
     const script = `
       tell application "Reminders"
         set output to ""
@@ -113,6 +136,9 @@ class AppleRemindersProvider {
                   if due date of aReminder is not missing value then
                     set output to output & "DUE:" & (due date of aReminder as string) & linefeed
                   end if
+                  if allday due date of aReminder is not missing value then
+                    set output to output & "ALLDAY:true" & linefeed
+                  end if
                 end try
                 try
                   if creation date of aReminder is not missing value then
@@ -128,7 +154,7 @@ class AppleRemindersProvider {
       end tell
     `;
     
-    const result = this.executeAppleScript(script);
+    const result = await this.executeAppleScript(script, options.signal);
     if (!result) {
       throw new Error('Task not found');
     }
@@ -153,7 +179,7 @@ class AppleRemindersProvider {
       end tell
     `;
     
-    const result = this.executeAppleScript(script);
+    const result = await this.executeAppleScript(script);
     if (result === 'not found') {
       throw new Error('Task not found');
     }
@@ -183,7 +209,7 @@ class AppleRemindersProvider {
       end tell
     `;
     
-    const result = this.executeAppleScript(script);
+    const result = await this.executeAppleScript(script);
     return { id: result, name: name };
   }
 
@@ -251,10 +277,13 @@ class AppleRemindersProvider {
           task.notes = trimmed.substring(6).trim();
         } else if (trimmed.startsWith('DUE:')) {
           task.dueDate = trimmed.substring(4).trim();
+        } else if (trimmed.startsWith('ALLDAY:')) {
+          task.allDay = true;
         }
       }
 
       if (task.id && task.name !== undefined) {
+        Object.assign(task, dates.fromAppleScript(task.dueDate, task.allDay));
         tasks.push(task);
       }
     }
@@ -283,12 +312,14 @@ class AppleRemindersProvider {
         task.notes = trimmed.substring(6).trim();
       } else if (trimmed.startsWith('DUE:')) {
         task.dueDate = trimmed.substring(4).trim();
+      } else if (trimmed.startsWith('ALLDAY:')) {
+        task.allDay = true;
       } else if (trimmed.startsWith('CREATED:')) {
         task.createdDate = trimmed.substring(8).trim();
       }
     }
 
-    return task;
+    return Object.assign(task, dates.fromAppleScript(task.dueDate, task.allDay));
   }
 }
 
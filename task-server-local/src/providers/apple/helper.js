@@ -0,0 +1,56 @@
+// Resident AppleScript runner for the Apple Reminders provider (JavaScript
+// for Automation, run by `osascript -l JavaScript`, not by Node). Reads
+// {"id", "script"} lines on stdin, runs each script in this one process, so
+// that osascript starts and connects to Reminders once, and answers with
+// {"id", "output"} or {"id", "error"} lines (see src/helpers.js). Exits when
+// stdin closes.
+
+ObjC.import('Foundation');
+
+function reply(stdout, message) {
+  var line = $.NSString.alloc.initWithUTF8String(JSON.stringify(message) + '\n');
+  stdout.writeData(line.dataUsingEncoding($.NSUTF8StringEncoding));
+}
+
+function runScript(source) {
+  var script = $.NSAppleScript.alloc.initWithSource(source);
+  var error = Ref();
+  var result = script.executeAndReturnError(error);
+  if (result.isNil()) {
+    var info = ObjC.deepUnwrap(error[0]) || {};
+    throw new Error(info.NSAppleScriptErrorMessage || 'AppleScript failed');
+  }
+  return ObjC.unwrap(result.stringValue) || '';
+}
+
+function run() {
+  var stdin = $.NSFileHandle.fileHandleWithStandardInput;
+  var stdout = $.NSFileHandle.fileHandleWithStandardOutput;
+  var buffer = '';
+
+  for (;;) {
+    var data = stdin.availableData;
+    if (data.length === 0) {
+      return;
+    }
+    // Requests are ASCII, so a chunk never ends inside a character
+    buffer += ObjC.unwrap($.NSString.alloc.initWithDataEncoding(data, $.NSUTF8StringEncoding));
+
+    var newline;
+    while ((newline = buffer.indexOf('\n')) >= 0) {
+      var line = buffer.slice(0, newline);
+      buffer = buffer.slice(newline + 1);
+      if (!line.trim()) {
+        continue;
+      }
+      var id = null;
+      try {
+        var request = JSON.parse(line);
+        id = request.id;
+        reply(stdout, { id: id, output: runScript(request.script).trim() });
+      } catch (e) {
+        reply(stdout, { id: id, error: e.message || String(e) });
+      }
+    }
+  }
+}
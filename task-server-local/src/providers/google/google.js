@@ -1,4 +1,5 @@
 const { google } = require('googleapis');
+const dates = require('../../dates');
 
 class GoogleTasksProvider {
   constructor(config) {
@@ -71,29 +72,45 @@ class GoogleTasksProvider {
 
   // Get tasks from a specific list
   async getTasks(listId) {
+    const tasks = [];
+    for await (const page of this.taskPages(listId)) {
+      tasks.push(...page);
+    }
+    return tasks;
+  }
+
+  // Tasks of a list, a page of the API at a time (for streaming)
+  async *taskPages(listId) {
     if (!this.tasksApi) {
       throw new Error('Client not initialized. Call initialize() first.');
     }
 
-    const response = await this.tasksApi.tasks.list({
-      tasklist: listId,
-      showCompleted: true,
-      showHidden: true
-    });
-
-    if (!response.data.items) {
-      return [];
-    }
+    let pageToken;
+    do {
+      const response = await this.tasksApi.tasks.list({
+        tasklist: listId,
+        showCompleted: true,
+        showHidden: true,
+        maxResults: 100,
+        pageToken
+      });
+      yield (response.data.items || []).map(task => this.toTask(task));
+      pageToken = response.data.nextPageToken;
+    } while (pageToken);
+  }
 
-    return response.data.items.map(task => ({
+  // API task in the server's task format
+  toTask(task) {
+    return {
       id: task.id,
       name: task.title,
       completed: task.status === 'completed',
       notes: task.notes,
       dueDate: task.due,
+      ...dates.fromDatePart(task.due),
       updated: task.updated,
       position: task.position
-    }));
+    };
   }
 
   // Get task details
@@ -115,6 +132,7 @@ class GoogleTasksProvider {
       completed: task.status === 'completed',
       notes: task.notes,
       dueDate: task.due,
+      ...dates.fromDatePart(task.due),
       updated: task.updated,
       position: task.position,
       parent: task.parent,
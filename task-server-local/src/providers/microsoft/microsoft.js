@@ -1,5 +1,6 @@
 const { Client } = require('@microsoft/microsoft-graph-client');
 const { ClientSecretCredential } = require('@azure/identity');
+const dates = require('../../dates');
 
 class MicrosoftTasksProvider {
   constructor(config) {
@@ -59,23 +60,39 @@ class MicrosoftTasksProvider {
 
   // Get tasks from a specific list
   async getTasks(listId) {
+    const tasks = [];
+    for await (const page of this.taskPages(listId)) {
+      tasks.push(...page);
+    }
+    return tasks;
+  }
+
+  // Tasks of a list, a page of the API at a time (for streaming)
+  async *taskPages(listId) {
     if (!this.client) {
       throw new Error('Client not initialized. Call initialize() first.');
     }
 
-    const response = await this.client
-      .api(`/me/todo/lists/${listId}/tasks`)
-      .get();
+    let url = `/me/todo/lists/${listId}/tasks`;
+    while (url) {
+      const response = await this.client.api(url).get();
+      yield response.value.map(task => this.toTask(task));
+      url = response['@odata.nextLink'];
+    }
+  }
 
-    return response.value.map(task => ({
+  // API task in the server's task format
+  toTask(task) {
+    return {
       id: task.id,
       name: task.title,
       completed: task.status === 'completed',
       importance: task.importance,
       dueDate: task.dueDateTime?.dateTime,
+      ...dates.fromDatePart(task.dueDateTime?.dateTime),
       createdDate: task.createdDateTime,
       body: task.body?.content
-    }));
+    };
   }
 
   // Get task details
@@ -94,6 +111,7 @@ class MicrosoftTasksProvider {
       completed: task.status === 'completed',
       importance: task.importance,
       dueDate: task.dueDateTime?.dateTime,
+      ...dates.fromDatePart(task.dueDateTime?.dateTime),
       createdDate: task.createdDateTime,
       lastModified: task.lastModifiedDateTime,
       body: task.body?.content,
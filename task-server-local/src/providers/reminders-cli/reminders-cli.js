@@ -1,37 +1,45 @@
-const { execSync } = require('child_process');
 const path = require('path');
+const dates = require('../../dates');
+const { runProcess } = require('../../processes');
+const { HelperPool } = require('../../helpers');
 
 class RemindersCliProvider {
-  constructor() {
+  constructor(config = {}) {
     this.name = 'Reminders CLI';
     // Path to the reminders executable (now in same directory)
-    this.cliPath = path.join(__dirname, 'reminders');
+    this.cliPath = config.cliPath || path.join(__dirname, 'reminders');
+    this.timeoutMs = config.timeoutMs || 60000;
+    // The reminders binary has no resident mode. config.helperPath names an
+    // executable that has: it takes {"args": [...]} commands as src/helpers.js
+    // describes and answers with what `reminders <args>` would print.
+    this.helpers = config.helperPath ?
+      new HelperPool(config.helperPath, [], { size: config.helpers || 2, timeoutMs: this.timeoutMs, name: 'Reminders CLI' }) :
+      null;
     // Cache list names to IDs mapping (CLI uses names, API uses IDs)
     this.listNameToId = {};
     this.listIdToName = {};
   }
 
-  // Execute reminders CLI command and return parsed JSON result
-  executeCommand(args) {
+  // Run a reminders CLI command and return its output. Arguments go to the
+  // CLI as they are, without a shell. signal (optional) kills the command
+  // when the client that wanted its output is gone.
+  async executeCommand(args, signal) {
     try {
-      const command = `"${this.cliPath}" ${args}`;
-      const result = execSync(command, {
-        encoding: 'utf-8',
-        maxBuffer: 10 * 1024 * 1024,
-        timeout: 60000 // 60 second timeout
-      });
-      return result.trim();
+      if (this.helpers) {
+        return await this.helpers.call({ args }, { signal });
+      }
+      return await runProcess(this.cliPath, args, { timeoutMs: this.timeoutMs, signal });
     } catch (error) {
-      if (error.killed) {
-        throw new Error(`Reminders CLI timeout: Command took longer than 60 seconds to execute`);
+      if (error.timedOut) {
+        throw new Error(`Reminders CLI timeout: Command took longer than ${this.timeoutMs / 1000} seconds to execute`);
       }
       throw new Error(`Reminders CLI error: ${error.message}`);
     }
   }
 
   // Get all task lists
-  async getLists() {
-    const output = this.executeCommand('show-lists --format json');
+  async getLists(options = {}) {
+    const output = await this.executeCommand(['show-lists', '--format', 'json'], options.signal);
     const listNames = JSON.parse(output);
 
     // Convert list names to the format expected by the API
@@ -56,14 +64,14 @@ class RemindersCliProvider {
     const listName = this.listIdToName[listId] || listId;
 
     // Build command with options
-    let args = `show "${this.escapeString(listName)}" --format json`;
+    const args = ['show', listName, '--format', 'json'];
 
     // Add options if specified
     if (options.showCompleted) {
-      args += ' --include-completed';
+      args.push('--include-completed');
     }
 
-    const output = this.executeCommand(args);
+    const output = await this.executeCommand(args, options.signal);
 
     if (!output || output.trim() === '[]') {
       return [];
@@ -78,11 +86,12 @@ class RemindersCliProvider {
       completed: task.isCompleted,
       notes: task.notes || '',
       dueDate: task.dueDate || null,
+      ...dates.fromInstant(task.dueDate),
       priority: task.priority,
       index: index // Store index for complete/delete operations
     }));
 
-    // Apply limit if specified
+    // Apply limit if specified (0: no limit)
     if (options.limit && tasks.length > options.limit) {
       return tasks.slice(0, options.limit);
     }
@@ -91,8 +100,8 @@ class RemindersCliProvider {
   }
 
   // Get task details (not directly supported by CLI, so fetch all and find by ID)
-  async getTask(listId, taskId) {
-    const tasks = await this.getTasks(listId, { showCompleted: true });
+  async getTask(listId, taskId, options = {}) {
+    const tasks = await this.getTasks(listId, { showCompleted: true, signal: options.signal });
     const task = tasks.find(t => t.id === taskId);
 
     if (!task) {
@@ -115,7 +124,7 @@ class RemindersCliProvider {
     const listName = this.listIdToName[listId] || listId;
     const taskIndex = task.index; // CLI uses 0-based indexing
 
-    this.executeCommand(`complete "${this.escapeString(listName)}" ${taskIndex}`);
+    await this.executeCommand(['complete', listName, String(taskIndex)]);
 
     return { success: true, message: 'Task marked as complete' };
   }
@@ -125,24 +134,24 @@ class RemindersCliProvider {
     const listName = this.listIdToName[listId] || listId;
     const title = taskData.name || taskData.title || 'Untitled Task';
 
-    let args = `add "${this.escapeString(listName)}" "${this.escapeString(title)}"`;
+    const args = ['add', listName, title];
 
     // Add optional parameters
     if (taskData.notes) {
-      args += ` --notes "${this.escapeString(taskData.notes)}"`;
+      args.push('--notes', taskData.notes);
     }
 
     if (taskData.dueDate) {
-      args += ` --due-date "${this.escapeString(taskData.dueDate)}"`;
+      args.push('--due-date', taskData.dueDate);
     }
 
     if (taskData.priority !== undefined) {
-      args += ` --priority ${taskData.priority}`;
+      args.push('--priority', String(taskData.priority));
     }
 
-    args += ' --format json';
+    args.push('--format', 'json');
 
-    const output = this.executeCommand(args);
+    await this.executeCommand(args);
 
     // The CLI might return the created task info or just success
     // Return a basic response
@@ -151,12 +160,6 @@ class RemindersCliProvider {
       name: title
     };
   }
-
-  // Helper to escape strings for shell commands
-  escapeString(str) {
-    // Escape double quotes and backslashes
-    return str.replace(/\\/g, '\\\\').replace(/"/g, '\\"');
-  }
 }
 
 module.exports = RemindersCliProvider;
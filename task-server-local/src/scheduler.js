@@ -0,0 +1,164 @@
+/**
+ * Provider call scheduling. Each provider runs at most `limit` calls at once
+ * (osascript one, the HTTP APIs several), so a slow provider only queues its
+ * own calls. Waiting calls start by priority class, then in arrival order:
+ *
+ *   write     complete and create, which a user is waiting on
+ *   read      list and task reads
+ *   refresh   background reloads of the cache
+ *
+ * When `maxQueue` calls of the same or a higher class already wait for a
+ * provider, a call is rejected at once with error.status 503 instead of
+ * queueing behind them. A burst of reads thus never turns writes away.
+ */
+
+const PRIORITIES = ['write', 'read', 'refresh'];
+
+const DEFAULT_LIMITS = { apple: 1, 'reminders-cli': 2, microsoft: 8, google: 8 };
+const DEFAULT_LIMIT = 4;
+const DEFAULT_MAX_QUEUE = 32;
+
+class Scheduler {
+  // limits: provider name -> concurrent calls; maxQueue: waiting calls per provider
+  constructor(options = {}) {
+    this.limits = Object.assign({}, DEFAULT_LIMITS, options.limits);
+    this.maxQueue = options.maxQueue || DEFAULT_MAX_QUEUE;
+    this.providers = new Map();  // name -> {running, queue, rejected, waits}
+  }
+
+  // Run fn() once a slot of the provider is free, and free it when done
+  async run(providerName, priority, fn, signal) {
+    const release = await this.acquire(providerName, priority, signal);
+    try {
+      return await fn();
+    } finally {
+      release();
+    }
+  }
+
+  // Wait for a slot of the provider; resolves with the function that frees it
+  acquire(providerName, priority, signal) {
+    const state = this.state(providerName);
+    const rank = PRIORITIES.indexOf(priority);
+    if (rank < 0) {
+      return Promise.reject(new Error(`Unknown priority ${priority}`));
+    }
+    if (signal && signal.aborted) {
+      return Promise.reject(Object.assign(new Error('Aborted'), { aborted: true }));
+    }
+    if (state.running < state.limit && state.queue.length === 0) {
+      return Promise.resolve(this.start(state, priority, Date.now()));
+    }
+    const ahead = state.queue.filter(waiter => waiter.rank <= rank).length;
+    if (ahead >= this.maxQueue) {
+      state.rejected++;
+      return Promise.reject(Object.assign(
+        new Error(`${providerName} is busy: ${ahead} calls already waiting`), { status: 503 }));
+    }
+
+    return new Promise((resolve, reject) => {
+      const waiter = { rank, priority, queuedAt: Date.now(), resolve, signal, onAbort: null };
+      if (signal) {
+        waiter.onAbort = () => {
+          const i = state.queue.indexOf(waiter);
+          if (i >= 0) {
+            state.queue.splice(i, 1);
+            reject(Object.assign(new Error('Aborted'), { aborted: true }));
+          }
+        };
+        signal.addEventListener('abort', waiter.onAbort);
+      }
+      // Behind every waiter of the same or a higher class
+      let i = state.queue.length;
+      while (i > 0 && state.queue[i - 1].rank > rank) i--;
+      state.queue.splice(i, 0, waiter);
+    });
+  }
+
+  // Running and waiting calls and queue waits per provider and class
+  snapshot() {
+    const providers = {};
+    for (const [name, state] of this.providers) {
+      const waits = {};
+      for (const priority of PRIORITIES) {
+        const w = state.waits[priority];
+        waits[priority] = {
+          started: w.started,
+          meanWaitMs: w.started ? Math.round(w.totalMs / w.started) : null,
+          maxWaitMs: w.maxMs
+        };
+      }
+      providers[name] = {
+        limit: state.limit,
+        running: state.running,
+        queued: state.queue.length,
+        rejected: state.rejected,
+        waits
+      };
+    }
+    return { maxQueue: this.maxQueue, providers };
+  }
+
+  state(providerName) {
+    const name = providerName.toLowerCase();
+    let state = this.providers.get(name);
+    if (!state) {
+      const waits = {};
+      for (const priority of PRIORITIES) {
+        waits[priority] = { started: 0, totalMs: 0, maxMs: 0 };
+      }
+      state = {
+        limit: Math.max(1, this.limits[name] || DEFAULT_LIMIT),
+        running: 0,
+        queue: [],
+        rejected: 0,
+        waits
+      };
+      this.providers.set(name, state);
+    }
+    return state;
+  }
+
+  start(state, priority, queuedAt) {
+    const waitMs = Date.now() - queuedAt;
+    const waits = state.waits[priority];
+    waits.started++;
+    waits.totalMs += waitMs;
+    waits.maxMs = Math.max(waits.maxMs, waitMs);
+    state.running++;
+
+    let released = false;
+    return () => {
+      if (released) {
+        return;
+      }
+      released = true;
+      state.running--;
+      this.next(state);
+    };
+  }
+
+  next(state) {
+    while (state.running < state.limit && state.queue.length) {
+      const waiter = state.queue.shift();
+      if (waiter.signal) {
+        waiter.signal.removeEventListener('abort', waiter.onAbort);
+      }
+      waiter.resolve(this.start(state, waiter.priority, waiter.queuedAt));
+    }
+  }
+}
+
+// "apple=1,google=8" -> {apple: 1, google: 8}
+function parseLimits(str) {
+  const limits = {};
+  for (const part of (str || '').split(',')) {
+    const [name, value] = part.split('=').map(s => s.trim());
+    if (name && parseInt(value, 10) > 0) {
+      limits[name.toLowerCase()] = parseInt(value, 10);
+    }
+  }
+  return limits;
+}
+
+module.exports = { Scheduler, parseLimits, PRIORITIES };
@@ -1,7 +1,13 @@
 require('dotenv').config();
+const crypto = require('crypto');
+const path = require('path');
 const express = require('express');
 const cors = require('cors');
 const bodyParser = require('body-parser');
+const dates = require('./dates');
+const { TaskCache } = require('./cache');
+const { Scheduler, parseLimits } = require('./scheduler');
+const { storeTrace } = require('./traces');
 
 const AppleRemindersProvider = require('./providers/apple/apple');
 const MicrosoftTasksProvider = require('./providers/microsoft/microsoft');
@@ -10,6 +16,7 @@ const RemindersCliProvider = require('./providers/reminders-cli/reminders-cli');
 
 const app = express();
 const PORT = process.env.PORT || 3000;
+const DEFAULT_TASK_LIMIT = 50;  // tasks per list without ?limit
 
 // Middleware
 app.use(cors());
@@ -17,7 +24,10 @@ app.use(bodyParser.json());
 
 // Provider instances
 const providers = {
-  apple: new AppleRemindersProvider(),
+  apple: new AppleRemindersProvider({
+    helper: process.env.APPLE_HELPER !== 'off',
+    helpers: parseInt(process.env.HELPER_POOL_SIZE) || 2
+  }),
   microsoft: new MicrosoftTasksProvider({
     clientId: process.env.MICROSOFT_CLIENT_ID,
     clientSecret: process.env.MICROSOFT_CLIENT_SECRET,
@@ -29,12 +39,141 @@ const providers = {
     clientSecret: process.env.GOOGLE_CLIENT_SECRET,
     redirectUri: process.env.GOOGLE_REDIRECT_URI
   }),
-  'reminders-cli': new RemindersCliProvider()
+  'reminders-cli': new RemindersCliProvider({
+    helperPath: process.env.REMINDERS_HELPER,
+    helpers: parseInt(process.env.HELPER_POOL_SIZE) || 2
+  })
 };
 
 // Session storage for tokens (in production, use a proper session store)
 const sessions = new Map();
 
+// Change versions of task lists, keyed by provider, list and query options.
+// A version is bumped whenever the content hash of the list changes.
+const listVersions = new Map();
+
+// Get the change version for a fetched task list
+function getListVersion(key, tasks) {
+  const hash = crypto.createHash('sha1').update(JSON.stringify(tasks)).digest('hex');
+  const entry = listVersions.get(key);
+  if (entry && entry.hash === hash) {
+    return entry.version;
+  }
+
+  // Seed from the clock so versions keep increasing across server restarts
+  const version = Math.max(entry ? entry.version + 1 : 0, Math.floor(Date.now() / 1000));
+  listVersions.set(key, { hash, version });
+  return version;
+}
+
+// Provider results, cached in memory (see cache.js)
+const taskCache = new TaskCache({
+  listsTtlMs: envInt('CACHE_LISTS_TTL_MS'),
+  tasksTtlMs: envInt('CACHE_TASKS_TTL_MS'),
+  recentMs: envInt('CACHE_RECENT_MS')
+});
+taskCache.startRefreshAhead();
+
+// Concurrency limits and priorities of provider calls (see scheduler.js)
+const scheduler = new Scheduler({
+  limits: parseLimits(process.env.PROVIDER_CONCURRENCY),
+  maxQueue: envInt('PROVIDER_QUEUE_LIMIT')
+});
+
+function envInt(name) {
+  const value = parseInt(process.env[name], 10);
+  return Number.isNaN(value) ? undefined : value;
+}
+
+// Cache scope of a request: its provider and credentials, so that users of a
+// provider never see each other's lists. Credentials are hashed, not kept.
+function cacheScope(providerName, req) {
+  const credentials = req.headers['x-session-id'] || req.headers['authorization'];
+  const name = providerName.toLowerCase();
+  return credentials ? `${name}:${crypto.createHash('sha1').update(credentials).digest('hex')}` : name;
+}
+
+// A provider read for the cache, run by the scheduler as a read, or as a
+// refresh when the cache reloads it in the background. Sets the provider up
+// with the request's credentials first, as the cache may call it later.
+function cachedLoad(provider, providerName, req, read) {
+  const auth = {
+    headers: { 'x-session-id': req.headers['x-session-id'], authorization: req.headers['authorization'] }
+  };
+  return (signal, refresh) => scheduler.run(providerName, refresh ? 'refresh' : 'read', async () => {
+    await initializeProvider(provider, providerName, auth);
+    return read(signal);
+  }, signal);
+}
+
+// Cache key of a task query
+function taskOptionsKey(options) {
+  return `${options.showCompleted}:${options.limit}`;
+}
+
+// Version key of a fetched task list: what the content depends on
+function taskListKey(providerName, listId, options, tzOffset) {
+  return `${providerName}:${listId}:${options.showCompleted}:${options.limit}:${tzOffset}`;
+}
+
+// Pages of tasks as the provider produces them; providers that fetch a list
+// in one go yield it whole
+async function* taskPages(provider, listId, options) {
+  if (provider.taskPages) {
+    yield* provider.taskPages(listId, options);
+  } else {
+    yield await provider.getTasks(listId, options);
+  }
+}
+
+// NDJSON variant of GET tasks: a {"type":"task"} line per task of pages (as
+// taskPages yields them) as soon as it arrives, then {"type":"end"} with the
+// count and version, or {"type":"error"}. There is no ETag, since the version
+// is known only at the end. Resolves with the provider's tasks once all were
+// sent, or null.
+async function streamTasks(res, pages, providerName, listId, versionKey, tzOffset) {
+  let closed = false;
+  res.on('close', () => { closed = true; });
+  res.set('Content-Type', 'application/x-ndjson');
+  res.set('Cache-Control', 'no-cache');
+
+  const fetched = [];
+  const tasks = [];
+  try {
+    for await (const page of pages) {
+      if (closed) {
+        return null;
+      }
+      fetched.push(...page);
+      const lines = dates.forClient(page, tzOffset).map(task => {
+        tasks.push(task);
+        return JSON.stringify({ type: 'task', task }) + '\n';
+      });
+      res.write(lines.join(''));
+    }
+    console.log(`Streamed ${tasks.length} tasks for list ${listId} from provider ${providerName}`);
+    const version = getListVersion(versionKey, tasks);
+    res.end(JSON.stringify({ type: 'end', provider: providerName, listId, count: tasks.length, version }) + '\n');
+    return fetched;
+  } catch (error) {
+    res.end(JSON.stringify({ type: 'error', error: error.message }) + '\n');
+    return null;
+  }
+}
+
+// Aborted when the client goes away before its response is complete, so the
+// CLI providers can kill work whose result nobody will read. Only reads take
+// it: a write that was started is left to finish.
+function requestSignal(res) {
+  const controller = new AbortController();
+  res.on('close', () => {
+    if (!res.writableFinished) {
+      controller.abort();
+    }
+  });
+  return controller.signal;
+}
+
 // Helper to get provider
 function getProvider(req) {
   const providerName = req.query.provider || req.body.provider || process.env.DEFAULT_PROVIDER || 'apple';
@@ -170,15 +309,15 @@ app.post('/auth/microsoft/token', (req, res) => {
 app.get('/api/lists', async (req, res) => {
   try {
     const { provider, providerName } = getProvider(req);
-    await initializeProvider(provider, providerName, req);
-    
-    const lists = await provider.getLists();
+    const load = cachedLoad(provider, providerName, req, signal => provider.getLists({ signal }));
+
+    const lists = await taskCache.lists(cacheScope(providerName, req), load, requestSignal(res));
     res.json({
       provider: providerName,
       lists
     });
   } catch (error) {
-    res.status(500).json({ error: error.message });
+    res.status(error.status || 500).json({ error: error.message });
   }
 });
 
@@ -191,26 +330,61 @@ app.get('/api/lists/:listId/tasks', async (req, res) => {
   try {
     const { listId } = req.params;
     const { provider, providerName } = getProvider(req);
-    await initializeProvider(provider, providerName, req);
 
-    // Get query parameters for filtering
+    // Get query parameters for filtering; limit=0 returns every task
+    const limit = parseInt(req.query.limit, 10);
     const options = {
       showCompleted: req.query.showCompleted === 'true',
-      limit: parseInt(req.query.limit) || 50
+      limit: limit >= 0 ? limit : DEFAULT_TASK_LIMIT
     };
+    // Client's Date.getTimezoneOffset(), for all-day due dates (see dates.js)
+    const tzOffset = parseInt(req.query.tzOffset, 10);
+    const versionKey = taskListKey(providerName, listId, options, tzOffset);
 
-    const tasks = await provider.getTasks(listId, options);
+    const scope = cacheScope(providerName, req);
+    const optionsKey = taskOptionsKey(options);
+    const signal = requestSignal(res);
+    const load = cachedLoad(provider, providerName, req, loadSignal =>
+      provider.getTasks(listId, { ...options, signal: loadSignal }));
+
+    if (req.query.stream === 'ndjson') {
+      // Cached: all in one go. Otherwise the pages of the provider call, or of
+      // the call in flight for the same list and query.
+      const cached = taskCache.peekTasks(scope, listId, optionsKey);
+      const pages = cached ? [cached] : taskCache.streamTasks(scope, listId, optionsKey, async function* (loadSignal) {
+        const release = await scheduler.acquire(providerName, 'read', loadSignal);
+        try {
+          await initializeProvider(provider, providerName, req);
+          yield* taskPages(provider, listId, { ...options, signal: loadSignal });
+        } finally {
+          release();
+        }
+      }, load, signal);
+      await streamTasks(res, pages, providerName, listId, versionKey, tzOffset);
+      return;
+    }
+
+    const tasks = dates.forClient(await taskCache.tasks(scope, listId, optionsKey, load, signal), tzOffset);
     console.log(`Fetched ${tasks.length} tasks for list ${listId} from provider ${providerName}`);
+
+    // Clients send back the version they hold in If-None-Match
+    const version = getListVersion(versionKey, tasks);
+    res.set('ETag', `"${version}"`);
+    if (req.fresh) {
+      return res.status(304).end();
+    }
+
     res.json({
       provider: providerName,
       listId,
+      version,
       count: tasks.length,
       limit: options.limit,
       showCompleted: options.showCompleted,
       tasks
     });
   } catch (error) {
-    res.status(500).json({ error: error.message });
+    res.status(error.status || 500).json({ error: error.message });
   }
 });
 
@@ -219,16 +393,18 @@ app.get('/api/lists/:listId/tasks/:taskId', async (req, res) => {
   try {
     const { listId, taskId } = req.params;
     const { provider, providerName } = getProvider(req);
-    await initializeProvider(provider, providerName, req);
-    
-    const task = await provider.getTask(listId, taskId);
+
+    const tzOffset = parseInt(req.query.tzOffset, 10);
+    const load = cachedLoad(provider, providerName, req, signal => provider.getTask(listId, taskId, { signal }));
+    const fetched = await taskCache.task(cacheScope(providerName, req), listId, taskId, load, requestSignal(res));
+    const [task] = dates.forClient([fetched], tzOffset);
     res.json({
       provider: providerName,
       listId,
       task
     });
   } catch (error) {
-    res.status(500).json({ error: error.message });
+    res.status(error.status || 500).json({ error: error.message });
   }
 });
 
@@ -238,16 +414,19 @@ app.post('/api/lists/:listId/tasks', async (req, res) => {
     const { listId } = req.params;
     const taskData = req.body;
     const { provider, providerName } = getProvider(req);
-    await initializeProvider(provider, providerName, req);
-    
-    const task = await provider.createTask(listId, taskData);
+
+    const task = await scheduler.run(providerName, 'write', async () => {
+      await initializeProvider(provider, providerName, req);
+      return provider.createTask(listId, taskData);
+    });
+    taskCache.invalidate(providerName.toLowerCase(), listId);
     res.status(201).json({
       provider: providerName,
       listId,
       task
     });
   } catch (error) {
-    res.status(500).json({ error: error.message });
+    res.status(error.status || 500).json({ error: error.message });
   }
 });
 
@@ -256,9 +435,12 @@ app.patch('/api/lists/:listId/tasks/:taskId/complete', async (req, res) => {
   try {
     const { listId, taskId } = req.params;
     const { provider, providerName } = getProvider(req);
-    await initializeProvider(provider, providerName, req);
-    
-    const result = await provider.completeTask(listId, taskId);
+
+    const result = await scheduler.run(providerName, 'write', async () => {
+      await initializeProvider(provider, providerName, req);
+      return provider.completeTask(listId, taskId);
+    });
+    taskCache.invalidate(providerName.toLowerCase(), listId);
     res.json({
       provider: providerName,
       listId,
@@ -266,8 +448,39 @@ app.patch('/api/lists/:listId/tasks/:taskId/complete', async (req, res) => {
       ...result
     });
   } catch (error) {
-    res.status(500).json({ error: error.message });
+    res.status(error.status || 500).json({ error: error.message });
+  }
+});
+
+// ============================================
+// Diagnostics
+// ============================================
+
+// Cache hit and miss counters, for tuning the CACHE_*_TTL_MS settings
+app.get('/api/cache', (req, res) => {
+  res.json(taskCache.snapshot());
+});
+
+// Provider calls running and waiting, rejections and queue waits, for tuning
+// PROVIDER_CONCURRENCY and PROVIDER_QUEUE_LIMIT
+app.get('/api/scheduler', (req, res) => {
+  res.json(scheduler.snapshot());
+});
+
+const TRACE_DIR = path.join(__dirname, '..', 'logs', 'traces');
+
+// Store a performance trace dumped by the watch (see src/traces.js); the
+// newest TRACE_KEEP are kept
+app.post('/api/trace', (req, res) => {
+  let stored;
+  try {
+    stored = storeTrace(TRACE_DIR, req.body, { keep: envInt('TRACE_KEEP') });
+  } catch (error) {
+    return res.status(500).json({ error: error.message });
   }
+  const count = Array.isArray(req.body.entries) ? req.body.entries.length : 0;
+  console.log(`Stored ${count} trace entries from ${req.body.platform} in ${stored.file}:`, stored.summary);
+  res.status(201).json({ file: path.basename(stored.file), summary: stored.summary });
 });
 
 // ============================================
@@ -298,6 +511,9 @@ app.listen(PORT, () => {
   console.log('  GET  /api/lists/:listId/tasks/:taskId');
   console.log('  POST /api/lists/:listId/tasks');
   console.log('  PATCH /api/lists/:listId/tasks/:taskId/complete');
+  console.log('  GET  /api/cache');
+  console.log('  GET  /api/scheduler');
+  console.log('  POST /api/trace');
   console.log('\nAuthentication:');
   console.log('  GET  /auth/google/url');
   console.log('  GET  /auth/google/callback');
@@ -0,0 +1,69 @@
+/**
+ * Single-flight: concurrent calls with the same key share one underlying
+ * call and its result, so a burst of identical reads (phone retries, several
+ * clients opening the same list) costs the provider one call.
+ *
+ * Each caller may pass its own AbortSignal. A caller that aborts stops
+ * waiting at once; the shared call is aborted only when every caller has.
+ */
+
+class SingleFlight {
+  constructor() {
+    this.flights = new Map();  // key -> {promise, controller, waiters}
+    this.stats = { calls: 0, shared: 0 };
+  }
+
+  // Resolve with fn(signal), or with the result of the call in flight for key
+  run(key, fn, signal) {
+    if (signal && signal.aborted) {
+      return Promise.reject(Object.assign(new Error('Aborted'), { aborted: true }));
+    }
+
+    let flight = this.flights.get(key);
+    if (flight) {
+      this.stats.shared++;
+    } else {
+      this.stats.calls++;
+      const controller = new AbortController();
+      flight = { controller, waiters: 0, promise: null };
+      flight.promise = Promise.resolve()
+        .then(() => fn(controller.signal))
+        .finally(() => {
+          if (this.flights.get(key) === flight) {
+            this.flights.delete(key);
+          }
+        });
+      this.flights.set(key, flight);
+    }
+    return this.wait(key, flight, signal);
+  }
+
+  // The call in flight for key, or null
+  pending(key) {
+    const flight = this.flights.get(key);
+    return flight ? flight.promise : null;
+  }
+
+  wait(key, flight, signal) {
+    flight.waiters++;
+    if (!signal) {
+      return flight.promise;
+    }
+    return new Promise((resolve, reject) => {
+      const onAbort = () => {
+        reject(Object.assign(new Error('Aborted'), { aborted: true }));
+        if (--flight.waiters === 0) {
+          // Nobody waits any more: stop the call, and let the next caller start afresh
+          flight.controller.abort();
+          if (this.flights.get(key) === flight) {
+            this.flights.delete(key);
+          }
+        }
+      };
+      signal.addEventListener('abort', onAbort);
+      flight.promise.then(resolve, reject).finally(() => signal.removeEventListener('abort', onAbort));
+    });
+  }
+}
+
+module.exports = { SingleFlight };
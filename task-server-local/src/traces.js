@@ -0,0 +1,61 @@
+/**
+ * Performance traces dumped by the watch (see src/c/trace.h) and posted by the
+ * phone: each is stored as a JSON file with a summary, and only the newest
+ * few are kept so that a trace build left running cannot fill the disk.
+ */
+
+const fs = require('fs');
+const path = require('path');
+
+const DEFAULT_KEEP = 20;
+
+// Summarize a watch trace: time from the first message to the first drawn
+// row, and the mean and worst cost of drawing a row. A draw is not timed
+// across a gap (entries the watch could not send).
+function summarizeTrace(entries) {
+  const firstInbox = entries.find(e => e.event === 'inbox');
+  const firstRow = firstInbox && entries.find(e => e.event === 'draw_row_done' && e.timeMs >= firstInbox.timeMs);
+  const rowCosts = [];
+  let rowStart = null;
+  for (const entry of entries) {
+    if (entry.event === 'gap') {
+      rowStart = null;
+    } else if (entry.event === 'draw_row') {
+      rowStart = entry.timeMs;
+    } else if (entry.event === 'draw_row_done' && rowStart !== null) {
+      rowCosts.push(entry.timeMs - rowStart);
+      rowStart = null;
+    }
+  }
+  const heapLow = entries.filter(e => e.event === 'heap_low').map(e => e.arg);
+  return {
+    missingEntries: entries.filter(e => e.event === 'gap').reduce((sum, e) => sum + e.count, 0),
+    timeToFirstRowMs: firstRow ? firstRow.timeMs - firstInbox.timeMs : null,
+    rowsDrawn: rowCosts.length,
+    meanRowDrawMs: rowCosts.length ? rowCosts.reduce((a, b) => a + b, 0) / rowCosts.length : null,
+    maxRowDrawMs: rowCosts.length ? Math.max(...rowCosts) : null,
+    heapLowBytes: heapLow.length ? Math.min(...heapLow) : null
+  };
+}
+
+// Write a posted trace and its summary to dir, then delete all but the newest
+// keep traces there. Returns {file, summary}; throws if it cannot be written.
+function storeTrace(dir, body, options = {}) {
+  const keep = options.keep === undefined ? DEFAULT_KEEP : options.keep;
+  const now = options.now || new Date();
+  const entries = Array.isArray(body.entries) ? body.entries : [];
+  const summary = summarizeTrace(entries);
+  const file = path.join(dir, `trace-${now.toISOString().replace(/[:.]/g, '-')}.json`);
+
+  fs.mkdirSync(dir, { recursive: true });
+  fs.writeFileSync(file, JSON.stringify({ ...body, summary }, null, 2));
+
+  // Names sort by time
+  const traces = fs.readdirSync(dir).filter(name => /^trace-.*\.json$/.test(name)).sort();
+  for (const name of traces.slice(0, Math.max(0, traces.length - Math.max(1, keep)))) {
+    fs.unlinkSync(path.join(dir, name));
+  }
+  return { file, summary };
+}
+
+module.exports = { summarizeTrace, storeTrace };
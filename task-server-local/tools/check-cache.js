@@ -0,0 +1,259 @@
+#!/usr/bin/env node
+/**
+ * Checks the provider result cache (src/cache.js): TTLs, the task index,
+ * invalidation on writes, refresh-ahead, and single-flight coalescing of
+ * misses and streamed reads (src/singleflight.js). Exits non-zero if any check fails.
+ *
+ *   npm run check
+ */
+
+const assert = require('assert');
+const { TaskCache } = require('../src/cache');
+const { SingleFlight } = require('../src/singleflight');
+
+const sleep = ms => new Promise(resolve => setTimeout(resolve, ms));
+
+// A provider read that counts its calls and returns the next value
+function loader(values) {
+  const load = async () => {
+    load.calls++;
+    return values[Math.min(load.calls - 1, values.length - 1)];
+  };
+  load.calls = 0;
+  return load;
+}
+
+const TASKS = [{ id: 'a', name: 'One' }, { id: 'b', name: 'Two' }];
+
+const checks = {
+  async 'serves repeated reads from memory'() {
+    const cache = new TaskCache();
+    const load = loader([TASKS]);
+    assert.strictEqual(await cache.tasks('apple', 'L', 'false:50', load), TASKS);
+    assert.strictEqual(await cache.tasks('apple', 'L', 'false:50', load), TASKS);
+    assert.strictEqual(load.calls, 1);
+    assert.deepStrictEqual(cache.snapshot().tasks, { hitRate: 0.5, hits: 1, misses: 1 });
+  },
+
+  async 'keeps queries and scopes apart'() {
+    const cache = new TaskCache();
+    const load = loader([TASKS]);
+    await cache.tasks('apple', 'L', 'false:50', load);
+    await cache.tasks('apple', 'L', 'true:50', load);
+    await cache.tasks('google:abc', 'L', 'false:50', load);
+    assert.strictEqual(load.calls, 3);
+  },
+
+  async 'reloads after the TTL'() {
+    const cache = new TaskCache({ tasksTtlMs: 50 });
+    const load = loader([TASKS, []]);
+    await cache.tasks('apple', 'L', '', load);
+    await sleep(60);
+    assert.deepStrictEqual(await cache.tasks('apple', 'L', '', load), []);
+    assert.strictEqual(load.calls, 2);
+  },
+
+  async 'does not cache with a TTL of 0'() {
+    const cache = new TaskCache({ listsTtlMs: 0 });
+    const load = loader([['Inbox']]);
+    await cache.lists('apple', load);
+    await cache.lists('apple', load);
+    assert.strictEqual(load.calls, 2);
+  },
+
+  async 'finds single tasks by id'() {
+    const cache = new TaskCache();
+    await cache.tasks('apple', 'L', '', loader([TASKS]));
+    assert.strictEqual(cache.findTask('apple', 'L', 'b'), TASKS[1]);
+    assert.strictEqual(cache.findTask('apple', 'L', 'c'), null);
+    assert.strictEqual(cache.findTask('apple', 'M', 'b'), null);
+    assert.deepStrictEqual(cache.snapshot().task, { hitRate: 1 / 3, hits: 1, misses: 2 });
+  },
+
+  async 'invalidates a list on writes, in every scope'() {
+    const cache = new TaskCache();
+    const load = loader([TASKS]);
+    await cache.tasks('google:abc', 'L', 'false:50', load);
+    await cache.tasks('google:def', 'L', 'true:50', load);
+    await cache.tasks('google:abc', 'M', 'false:50', load);
+    cache.invalidate('google', 'L');
+    await cache.tasks('google:abc', 'L', 'false:50', load);
+    await cache.tasks('google:def', 'L', 'true:50', load);
+    await cache.tasks('google:abc', 'M', 'false:50', load);
+    assert.strictEqual(load.calls, 5);
+  },
+
+  async 'drops a read that started before a write'() {
+    const cache = new TaskCache();
+    let finish;
+    const slow = () => new Promise(resolve => { finish = resolve; });
+    const pending = cache.tasks('apple', 'L', '', slow);
+    await sleep(0);
+    cache.invalidate('apple', 'L');
+    finish(TASKS);
+    await pending;
+    const load = loader([[]]);
+    assert.deepStrictEqual(await cache.tasks('apple', 'L', '', load), []);
+    assert.strictEqual(load.calls, 1);
+  },
+
+  async 'refreshes recently used entries before they expire'() {
+    const cache = new TaskCache({ tasksTtlMs: 100, refreshIntervalMs: 20 });
+    const load = loader([TASKS, [TASKS[0]]]);
+    await cache.tasks('apple', 'L', '', load);
+    cache.startRefreshAhead();
+    await sleep(130);
+    cache.stop();
+    assert.ok(load.calls >= 2, `${load.calls} loads`);
+    assert.deepStrictEqual(await cache.tasks('apple', 'L', '', load), [TASKS[0]]);
+    assert.strictEqual(cache.snapshot().tasks.misses, 1);
+  },
+
+  async 'shares one load between identical misses'() {
+    const cache = new TaskCache({ tasksTtlMs: 0 });
+    let calls = 0;
+    const slow = async () => {
+      calls++;
+      await sleep(30);
+      return TASKS;
+    };
+    const results = await Promise.all([
+      cache.tasks('apple', 'L', 'false:50', slow),
+      cache.tasks('apple', 'L', 'false:50', slow),
+      cache.tasks('apple', 'L', 'true:50', slow),
+      cache.task('apple', 'L', 'a', slow),
+      cache.task('apple', 'L', 'a', slow)
+    ]);
+    assert.strictEqual(calls, 3);
+    assert.strictEqual(results[0], results[1]);
+    assert.deepStrictEqual(cache.snapshot().sharedCalls, 2);
+    await cache.tasks('apple', 'L', 'false:50', slow);
+    assert.strictEqual(calls, 4);  // nothing in flight any more, and no caching
+  },
+
+  async 'shares failures too'() {
+    const flights = new SingleFlight();
+    let calls = 0;
+    const failing = async () => {
+      calls++;
+      await sleep(10);
+      throw new Error('provider down');
+    };
+    const results = await Promise.allSettled([flights.run('k', failing), flights.run('k', failing)]);
+    assert.deepStrictEqual(results.map(r => r.reason.message), ['provider down', 'provider down']);
+    assert.strictEqual(calls, 1);
+  },
+
+  async 'aborts a shared call only when all callers did'() {
+    const flights = new SingleFlight();
+    let sharedSignal = null;
+    const slow = signal => {
+      sharedSignal = signal;
+      return sleep(50).then(() => 'done');
+    };
+    const first = new AbortController();
+    const second = new AbortController();
+    const a = flights.run('k', slow, first.signal);
+    const b = flights.run('k', slow, second.signal);
+    await sleep(0);
+    first.abort();
+    await assert.rejects(a, /Aborted/);
+    assert.strictEqual(sharedSignal.aborted, false);
+    second.abort();
+    await assert.rejects(b, /Aborted/);
+    assert.strictEqual(sharedSignal.aborted, true);
+    assert.strictEqual(flights.pending('k'), null);
+  },
+
+  async 'shares one streamed read between concurrent streams'() {
+    const cache = new TaskCache();
+    let calls = 0;
+    const pages = async function* () {
+      calls++;
+      for (const task of TASKS) {
+        await sleep(10);
+        yield [task];
+      }
+    };
+    const collect = async stream => {
+      const got = [];
+      for await (const page of stream) got.push(...page);
+      return got;
+    };
+    const first = collect(cache.streamTasks('apple', 'L', '', pages, loader([TASKS])));
+    await sleep(15);  // the first page is out
+    const second = collect(cache.streamTasks('apple', 'L', '', pages, loader([TASKS])));
+    const plain = cache.tasks('apple', 'L', '', loader([[]]));
+    assert.deepStrictEqual(await first, TASKS);
+    assert.deepStrictEqual(await second, TASKS);
+    assert.deepStrictEqual(await plain, TASKS);
+    assert.strictEqual(calls, 1);
+    assert.strictEqual(cache.snapshot().sharedCalls, 2);
+    assert.deepStrictEqual(cache.peekTasks('apple', 'L', ''), TASKS);
+  },
+
+  async 'streams a plain read in flight in one go'() {
+    const cache = new TaskCache();
+    const slow = async () => {
+      await sleep(20);
+      return TASKS;
+    };
+    const plain = cache.tasks('apple', 'L', '', slow);
+    const pages = [];
+    for await (const page of cache.streamTasks('apple', 'L', '', () => { throw new Error('second call'); }, slow)) {
+      pages.push(page);
+    }
+    assert.deepStrictEqual(pages, [TASKS]);
+    assert.strictEqual(await plain, TASKS);
+  },
+
+  async 'stops a streamed read only when every stream has gone'() {
+    const cache = new TaskCache();
+    let readSignal = null;
+    const pages = async function* (signal) {
+      readSignal = signal;
+      yield [TASKS[0]];
+      await sleep(30);
+      yield [TASKS[1]];
+    };
+    const first = new AbortController();
+    const second = new AbortController();
+    const a = cache.streamTasks('apple', 'L', '', pages, loader([TASKS]), first.signal);
+    const b = cache.streamTasks('apple', 'L', '', pages, loader([TASKS]), second.signal);
+    assert.deepStrictEqual((await a.next()).value, [TASKS[0]]);
+    assert.deepStrictEqual((await b.next()).value, [TASKS[0]]);
+    first.abort();
+    await assert.rejects(a.next(), /Aborted/);
+    assert.strictEqual(readSignal.aborted, false);
+    second.abort();
+    await assert.rejects(b.next(), /Aborted/);
+    assert.strictEqual(readSignal.aborted, true);
+  },
+
+  async 'lets entries nobody uses expire'() {
+    const cache = new TaskCache({ tasksTtlMs: 30, recentMs: 10, refreshIntervalMs: 20 });
+    const load = loader([TASKS]);
+    await cache.tasks('apple', 'L', '', load);
+    cache.startRefreshAhead();
+    await sleep(70);
+    cache.stop();
+    assert.strictEqual(load.calls, 1);
+    assert.strictEqual(cache.snapshot().entries, 0);
+  }
+};
+
+async function main() {
+  let failed = 0;
+  for (const name of Object.keys(checks)) {
+    try {
+      await checks[name]();
+      console.log(`ok    ${name}`);
+    } catch (error) {
+      failed++;
+      console.log(`FAIL  ${name}: ${error.message}`);
+    }
+  }
+  process.exit(failed ? 1 : 0);
+}
+
+main();
@@ -0,0 +1,123 @@
+#!/usr/bin/env node
+/**
+ * Checks the resident helper pool (src/helpers.js) and the reminders-cli
+ * provider on top of it, against tools/fake-helper.js. Runs anywhere Node
+ * does; exits non-zero if any check fails.
+ *
+ *   npm run check
+ */
+
+const assert = require('assert');
+const path = require('path');
+const { HelperPool } = require('../src/helpers');
+const RemindersCliProvider = require('../src/providers/reminders-cli/reminders-cli');
+
+const FAKE_HELPER = path.join(__dirname, 'fake-helper.js');
+
+async function rejects(promise, flag) {
+  try {
+    await promise;
+  } catch (error) {
+    assert.ok(error[flag], `expected ${flag}, got ${error.message}`);
+    return;
+  }
+  assert.fail(`expected a rejection with ${flag}`);
+}
+
+const checks = {
+  async 'reuses one helper for sequential calls'() {
+    const pool = new HelperPool(FAKE_HELPER, [], { size: 2 });
+    const pids = new Set();
+    for (let i = 0; i < 20; i++) {
+      pids.add(await pool.call({ args: ['pid'] }));
+    }
+    assert.strictEqual(pids.size, 1);
+    assert.strictEqual(pool.stats.starts, 1);
+    pool.close();
+  },
+
+  async 'spreads concurrent calls over the pool'() {
+    const pool = new HelperPool(FAKE_HELPER, [], { size: 2 });
+    const pids = await Promise.all([pool.call({ args: ['pid'] }), pool.call({ args: ['pid'] })]);
+    assert.notStrictEqual(pids[0], pids[1]);
+    const start = Date.now();
+    await Promise.all([1, 2, 3, 4].map(() => pool.call({ args: ['sleep', '200'] })));
+    const elapsed = Date.now() - start;
+    assert.strictEqual(pool.stats.starts, 2);
+    assert.ok(elapsed >= 400 && elapsed < 700, `4 x 200 ms on 2 helpers took ${elapsed} ms`);
+    pool.close();
+  },
+
+  async 'restarts a helper that crashed'() {
+    const pool = new HelperPool(FAKE_HELPER, [], { size: 1 });
+    const before = await pool.call({ args: ['pid'] });
+    await rejects(pool.call({ args: ['crash'] }), 'helperFailed');
+    const after = await pool.call({ args: ['pid'] });
+    assert.notStrictEqual(before, after);
+    assert.strictEqual(pool.stats.crashes, 1);
+    pool.close();
+  },
+
+  async 'kills a helper that timed out'() {
+    const pool = new HelperPool(FAKE_HELPER, [], { size: 1, timeoutMs: 300 });
+    await pool.call({ args: ['pid'] });
+    const queued = pool.call({ args: ['echo', 'queued'] }, { timeoutMs: 1000 });
+    await rejects(pool.call({ args: ['sleep', '1000'] }), 'timedOut');
+    assert.strictEqual(await queued, 'queued');  // answered before the stuck one
+    assert.strictEqual(await pool.call({ args: ['echo', 'next'] }), 'next');
+    assert.strictEqual(pool.stats.starts, 2);
+    pool.close();
+  },
+
+  async 'abandons an aborted call and keeps the helper'() {
+    const pool = new HelperPool(FAKE_HELPER, [], { size: 1 });
+    const controller = new AbortController();
+    setTimeout(() => controller.abort(), 50);
+    await rejects(pool.call({ args: ['sleep', '200'] }, { signal: controller.signal }), 'aborted');
+    assert.strictEqual(await pool.call({ args: ['echo', 'after'] }), 'after');
+    assert.strictEqual(pool.stats.starts, 1);
+    pool.close();
+  },
+
+  async 'fails calls when the helper cannot start'() {
+    const pool = new HelperPool(path.join(__dirname, 'no-such-helper'), [], { size: 1 });
+    await rejects(pool.call({ args: ['pid'] }), 'helperFailed');
+    pool.close();
+  },
+
+  async 'passes text through unchanged'() {
+    const pool = new HelperPool(FAKE_HELPER);
+    const text = 'Épicerie ✓ "quoted" \\ $HOME 日本';
+    assert.strictEqual(await pool.call({ args: ['echo', text] }), text);
+    pool.close();
+  },
+
+  async 'serves the reminders-cli provider'() {
+    const provider = new RemindersCliProvider({ helperPath: FAKE_HELPER });
+    assert.deepStrictEqual((await provider.getLists()).map(l => l.name), ['Inbox', 'Work']);
+    const tasks = await provider.getTasks('Inbox');
+    assert.strictEqual(tasks.length, 2);
+    assert.strictEqual(tasks[0].dueEpoch, Date.parse('2026-01-17T00:00:00Z') / 1000);
+    await provider.completeTask('Inbox', tasks[1].id);
+    assert.deepStrictEqual((await provider.getTasks('Inbox')).map(t => t.name), ['Buy milk']);
+    await assert.rejects(provider.getTasks('Nowhere'), /Reminders CLI error: No reminders list/);
+    assert.strictEqual(provider.helpers.stats.starts, 1);
+    provider.helpers.close();
+  }
+};
+
+async function main() {
+  let failed = 0;
+  for (const name of Object.keys(checks)) {
+    try {
+      await checks[name]();
+      console.log(`ok    ${name}`);
+    } catch (error) {
+      failed++;
+      console.log(`FAIL  ${name}: ${error.message}`);
+    }
+  }
+  process.exit(failed ? 1 : 0);
+}
+
+main();
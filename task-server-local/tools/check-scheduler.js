@@ -0,0 +1,112 @@
+#!/usr/bin/env node
+/**
+ * Checks provider call scheduling (src/scheduler.js): concurrency limits,
+ * priority classes, queue limits and queue-wait metrics. Exits non-zero if
+ * any check fails.
+ *
+ *   npm run check
+ */
+
+const assert = require('assert');
+const { Scheduler, parseLimits } = require('../src/scheduler');
+
+const sleep = ms => new Promise(resolve => setTimeout(resolve, ms));
+
+// A call that records when it ran and how many ran at once
+function tracker() {
+  const t = { running: 0, maxRunning: 0, order: [] };
+  t.call = (name, ms) => async () => {
+    t.running++;
+    t.maxRunning = Math.max(t.maxRunning, t.running);
+    t.order.push(name);
+    await sleep(ms);
+    t.running--;
+    return name;
+  };
+  return t;
+}
+
+const checks = {
+  async 'keeps to the limit of each provider'() {
+    const scheduler = new Scheduler({ limits: { apple: 1, google: 3 } });
+    const apple = tracker();
+    const google = tracker();
+    const start = Date.now();
+    await Promise.all([
+      ...[1, 2, 3].map(n => scheduler.run('apple', 'read', apple.call(n, 20))),
+      ...[1, 2, 3, 4, 5, 6].map(n => scheduler.run('google', 'read', google.call(n, 20)))
+    ]);
+    assert.strictEqual(apple.maxRunning, 1);
+    assert.strictEqual(google.maxRunning, 3);
+    // Both providers ran side by side: about 3 x 20 ms, not 9 x 20 ms
+    assert.ok(Date.now() - start < 120, `took ${Date.now() - start} ms`);
+  },
+
+  async 'starts writes before waiting reads and refreshes'() {
+    const scheduler = new Scheduler({ limits: { apple: 1 } });
+    const t = tracker();
+    await Promise.all([
+      scheduler.run('apple', 'read', t.call('read 1', 10)),
+      scheduler.run('apple', 'refresh', t.call('refresh', 10)),
+      scheduler.run('apple', 'read', t.call('read 2', 10)),
+      scheduler.run('apple', 'write', t.call('write', 10))
+    ]);
+    assert.deepStrictEqual(t.order, ['read 1', 'write', 'read 2', 'refresh']);
+    const waits = scheduler.snapshot().providers.apple.waits;
+    assert.strictEqual(waits.write.started, 1);
+    assert.ok(waits.write.maxWaitMs < waits.refresh.maxWaitMs);
+  },
+
+  async 'rejects at once when the queue is full, but not writes'() {
+    const scheduler = new Scheduler({ limits: { apple: 1 }, maxQueue: 2 });
+    const t = tracker();
+    const calls = [1, 2, 3].map(n => scheduler.run('apple', 'read', t.call(n, 20)));
+    const start = Date.now();
+    await assert.rejects(scheduler.run('apple', 'read', t.call(4, 20)), error => error.status === 503);
+    assert.ok(Date.now() - start < 10);
+    await scheduler.run('apple', 'write', t.call('write', 1));
+    await Promise.all(calls);
+    assert.strictEqual(scheduler.snapshot().providers.apple.rejected, 1);
+  },
+
+  async 'drops waiting calls whose client is gone'() {
+    const scheduler = new Scheduler({ limits: { apple: 1 } });
+    const t = tracker();
+    const controller = new AbortController();
+    const first = scheduler.run('apple', 'read', t.call('first', 30));
+    const dropped = scheduler.run('apple', 'read', t.call('dropped', 10), controller.signal);
+    controller.abort();
+    await assert.rejects(dropped, /Aborted/);
+    assert.strictEqual(scheduler.snapshot().providers.apple.queued, 0);
+    await first;
+    assert.deepStrictEqual(t.order, ['first']);
+  },
+
+  async 'frees the slot of a call that failed'() {
+    const scheduler = new Scheduler({ limits: { apple: 1 } });
+    await assert.rejects(scheduler.run('apple', 'read', async () => { throw new Error('boom'); }), /boom/);
+    assert.strictEqual(await scheduler.run('apple', 'read', async () => 'next'), 'next');
+    assert.strictEqual(scheduler.snapshot().providers.apple.running, 0);
+  },
+
+  async 'parses PROVIDER_CONCURRENCY'() {
+    assert.deepStrictEqual(parseLimits('apple=1, Google=8,bad,x=0'), { apple: 1, google: 8 });
+    assert.deepStrictEqual(parseLimits(undefined), {});
+  }
+};
+
+async function main() {
+  let failed = 0;
+  for (const name of Object.keys(checks)) {
+    try {
+      await checks[name]();
+      console.log(`ok    ${name}`);
+    } catch (error) {
+      failed++;
+      console.log(`FAIL  ${name}: ${error.message}`);
+    }
+  }
+  process.exit(failed ? 1 : 0);
+}
+
+main();
@@ -0,0 +1,77 @@
+#!/usr/bin/env node
+/**
+ * Checks storage of watch performance traces (src/traces.js): summaries, and
+ * that only the newest traces are kept. Exits non-zero if any check fails.
+ *
+ *   npm run check
+ */
+
+const assert = require('assert');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { summarizeTrace, storeTrace } = require('../src/traces');
+
+const ENTRIES = [
+  { timeMs: 100, event: 'inbox', arg: 0 },
+  { timeMs: 140, event: 'draw_row', arg: 0 },
+  { timeMs: 142, event: 'draw_row_done', arg: 0 },
+  { timeMs: 150, event: 'draw_row', arg: 1 },
+  { event: 'gap', count: 3 },
+  { timeMs: 190, event: 'draw_row_done', arg: 1 },
+  { timeMs: 200, event: 'heap_low', arg: 9120 }
+];
+
+function tempDir() {
+  return fs.mkdtempSync(path.join(os.tmpdir(), 'traces-'));
+}
+
+const checks = {
+  async 'summarizes a trace, not timing draws across a gap'() {
+    assert.deepStrictEqual(summarizeTrace(ENTRIES), {
+      missingEntries: 3,
+      timeToFirstRowMs: 42,
+      rowsDrawn: 1,
+      meanRowDrawMs: 2,
+      maxRowDrawMs: 2,
+      heapLowBytes: 9120
+    });
+  },
+
+  async 'stores a trace with its summary'() {
+    const dir = tempDir();
+    const { file, summary } = storeTrace(dir, { platform: 'basalt', entries: ENTRIES });
+    const stored = JSON.parse(fs.readFileSync(file, 'utf8'));
+    assert.strictEqual(stored.platform, 'basalt');
+    assert.deepStrictEqual(stored.summary, summary);
+    fs.rmSync(dir, { recursive: true });
+  },
+
+  async 'keeps only the newest traces'() {
+    const dir = tempDir();
+    fs.writeFileSync(path.join(dir, 'notes.txt'), '');
+    const files = [];
+    for (let i = 0; i < 5; i++) {
+      const now = new Date(Date.UTC(2026, 1, 5, 10, 0, i));
+      files.push(path.basename(storeTrace(dir, { entries: [] }, { keep: 3, now }).file));
+    }
+    assert.deepStrictEqual(fs.readdirSync(dir).sort(), ['notes.txt', ...files.slice(2)]);
+    fs.rmSync(dir, { recursive: true });
+  }
+};
+
+async function main() {
+  let failed = 0;
+  for (const name of Object.keys(checks)) {
+    try {
+      await checks[name]();
+      console.log(`ok    ${name}`);
+    } catch (error) {
+      failed++;
+      console.log(`FAIL  ${name}: ${error.message}`);
+    }
+  }
+  process.exit(failed ? 1 : 0);
+}
+
+main();
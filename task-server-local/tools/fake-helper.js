@@ -0,0 +1,97 @@
+#!/usr/bin/env node
+/**
+ * Stand-in for a resident reminders helper (see src/helpers.js), so the
+ * reminders-cli provider and the helper pool run on Linux:
+ *
+ *   REMINDERS_HELPER=tools/fake-helper.js npm start
+ *
+ * Answers {"id", "args"} commands one at a time, from in-memory lists, the
+ * way `reminders <args> --format json` would. For tests it also knows
+ *   echo <words>    output the words
+ *   pid             output its process id
+ *   sleep <ms>      wait, then output "slept"
+ *   crash           exit with code 3
+ */
+
+const readline = require('readline');
+
+const lists = {
+  Inbox: [
+    { title: 'Buy milk', dueDate: '2026-01-17T00:00:00Z', priority: 0 },
+    { title: 'Call the bank', notes: 'Before noon', priority: 1 }
+  ],
+  Work: [
+    { title: 'Review the backlog', dueDate: '2026-01-19T09:30:00Z', priority: 5 }
+  ]
+};
+let nextId = 1;
+for (const name of Object.keys(lists)) {
+  for (const reminder of lists[name]) {
+    Object.assign(reminder, { externalId: `fake-${nextId++}`, list: name, isCompleted: false });
+  }
+}
+
+function option(args, name) {
+  const i = args.indexOf(name);
+  return i >= 0 ? args[i + 1] : undefined;
+}
+
+function reminders(args) {
+  const list = lists[args[1]];
+  switch (args[0]) {
+    case 'show-lists':
+      return JSON.stringify(Object.keys(lists));
+    case 'show':
+      if (!list) throw new Error(`No reminders list matching ${args[1]}`);
+      return JSON.stringify(list.filter(r => args.includes('--include-completed') || !r.isCompleted));
+    case 'complete': {
+      if (!list) throw new Error(`No reminders list matching ${args[1]}`);
+      const reminder = list.filter(r => !r.isCompleted)[parseInt(args[2], 10)];
+      if (!reminder) throw new Error(`No reminder at index ${args[2]} on ${args[1]}`);
+      reminder.isCompleted = true;
+      return `Completed '${reminder.title}'`;
+    }
+    case 'add': {
+      if (!list) throw new Error(`No reminders list matching ${args[1]}`);
+      const reminder = {
+        externalId: `fake-${nextId++}`, list: args[1], title: args[2], isCompleted: false,
+        notes: option(args, '--notes'), dueDate: option(args, '--due-date'),
+        priority: parseInt(option(args, '--priority') || '0', 10)
+      };
+      list.push(reminder);
+      return JSON.stringify(reminder);
+    }
+    case 'echo':
+      return args.slice(1).join(' ');
+    case 'pid':
+      return String(process.pid);
+    default:
+      throw new Error(`Unknown command ${args[0]}`);
+  }
+}
+
+function handle(request) {
+  const args = request.args || [];
+  if (args[0] === 'crash') {
+    process.exit(3);
+  }
+  if (args[0] === 'sleep') {
+    return new Promise(resolve => setTimeout(() => resolve('slept'), parseInt(args[1], 10)));
+  }
+  return reminders(args);
+}
+
+// One command at a time, in order, like the real helpers
+let queue = Promise.resolve();
+readline.createInterface({ input: process.stdin }).on('line', line => {
+  queue = queue.then(async () => {
+    let id = null;
+    try {
+      const request = JSON.parse(line);
+      id = request.id;
+      process.stdout.write(JSON.stringify({ id, output: await handle(request) }) + '\n');
+    } catch (e) {
+      process.stdout.write(JSON.stringify({ id, error: e.message }) + '\n');
+    }
+  });
+});
@@ -0,0 +1,67 @@
+#!/usr/bin/env node
+/**
+ * Runs the scripted scenarios of the README over a range of seeds and fails
+ * unless every list the watch opened arrived in full, with all of its tasks
+ * counted (the task server returns 50 unless asked), its first rows came
+ * before a slow provider was done, and every task detail opened got its notes,
+ * so that a phone script change that stalls on a lossy link fails the build
+ * instead of a replay.
+ *
+ *   node tools/replay/check.js [seeds]    (default 20)
+ */
+
+const { Simulation } = require('./simulator');
+
+const SCENARIOS = {
+  'tasks 1000': { tasks: 1000 },
+  'lossy link': { busyRate: 0.1, ackRate: 0.95, latencyMs: 80 },
+  'relaunch': { launches: 2, thinkMs: 1500 },
+  'aplite inbox': { inboxSize: 1024 },
+  'very lossy relaunch': { busyRate: 0.3, ackRate: 0.8, launches: 2, thinkMs: 1500 },
+  'very lossy notes': { busyRate: 0.3, ackRate: 0.8, openNotes: true },
+  // 40 tasks in pages of 10 take the provider 2 s; the first rows must not wait for them
+  'slow provider': { tasks: 40, serverPageTasks: 10, serverTaskMs: 50, maxCountAfterMs: 1000 }
+};
+
+function failure(report, scenario) {
+  const tasks = scenario.tasks || 100;
+  const opened = report.streams.filter(s => s.type === 'tasks');
+  if (!report.streams.length) {
+    return 'no streams: the watch never got the ready message';
+  }
+  if (!opened.length) {
+    return 'the watch never opened a list';
+  }
+  const stalled = opened.find(s => s.timeToFullMs === null);
+  if (stalled) {
+    return `list ${stalled.listId} stalled at ${stalled.rows}/${stalled.expected} rows`;
+  }
+  // The whole list reached the watch, not the server's default limit
+  const short = opened.find(s => s.count !== tasks);
+  if (short) {
+    return `list ${short.listId} has ${short.count} of ${tasks} tasks`;
+  }
+  const late = scenario.maxCountAfterMs && opened.find(s => s.countAfterMs > scenario.maxCountAfterMs);
+  if (late) {
+    return `the first rows of list ${late.listId} came after ${late.countAfterMs}ms`;
+  }
+  const waiting = report.notes.find(n => n.timeToNotesMs === null);
+  return waiting ? `the notes of task ${waiting.taskId} never arrived` : null;
+}
+
+function main() {
+  const seeds = Number(process.argv[2]) || 20;
+  let failed = 0;
+  for (const name of Object.keys(SCENARIOS)) {
+    const failures = [];
+    for (let seed = 1; seed <= seeds; seed++) {
+      const reason = failure(new Simulation(Object.assign({ seed }, SCENARIOS[name])).run(), SCENARIOS[name]);
+      if (reason) failures.push(`seed ${seed}: ${reason}`);
+    }
+    failed += failures.length;
+    console.log(failures.length ? `FAIL  ${name}\n      ${failures.join('\n      ')}` : `ok    ${name} (${seeds} seeds)`);
+  }
+  process.exit(failed ? 1 : 0);
+}
+
+main();
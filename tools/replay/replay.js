@@ -0,0 +1,138 @@
+#!/usr/bin/env node
+/**
+ * Replays phone <-> watch message traffic against a simulated watch link and
+ * reports how long each list took to arrive in full.
+ *
+ *   node tools/replay/replay.js [recording.log] [options]
+ *
+ * Without a recording, a scripted watch connects, requests the lists and opens
+ * the first one. With a recording (the phone log of a session with "Record
+ * watch messages" on), the watch's requests are replayed at their recorded
+ * times. Either way, the phone side is the real src/pkjs/index.js, or --script
+ * to compare another version of it.
+ */
+
+const fs = require('fs');
+const { Simulation, parseRecording, DEFAULTS } = require('./simulator');
+
+const OPTIONS = {
+  '--seed': ['seed', 'PRNG seed for jitter and injected failures'],
+  '--latency': ['latencyMs', 'one-way link latency (ms)'],
+  '--jitter': ['jitterMs', 'extra random latency per hop (ms)'],
+  '--bandwidth': ['bandwidth', 'link throughput (bytes/s)'],
+  '--ack-rate': ['ackRate', 'share of messages ACKed, the rest time out'],
+  '--busy-rate': ['busyRate', 'share of messages NACKed as APP_MSG_BUSY'],
+  '--nack-delay': ['nackDelayMs', 'time until a lost message is NACKed (ms)'],
+  '--process': ['processMs', 'watch time per message (ms)'],
+  '--inbox': ['inboxSize', 'watch inbox size (bytes)'],
+  '--server-latency': ['serverLatencyMs', 'task server response time (ms)'],
+  '--server-task': ['serverTaskMs', 'provider time per task of a list (ms)'],
+  '--server-page': ['serverPageTasks', 'tasks per provider page in NDJSON streams'],
+  '--lists': ['lists', 'synthetic lists (default 3)'],
+  '--tasks': ['tasks', 'synthetic tasks per list (default 100)'],
+  '--open-list': ['openList', 'list the scripted watch opens'],
+  '--think': ['thinkMs', 'time before the scripted watch opens it (ms)'],
+  '--open-notes': ['openNotes', '1: then open the notes of its first task'],
+  '--launches': ['launches', 'scripted app launches, sharing localStorage'],
+  '--until': ['untilMs', 'virtual time limit (ms)']
+};
+
+function usage() {
+  console.log('Usage: node tools/replay/replay.js [recording] [options]\n');
+  for (const flag of Object.keys(OPTIONS)) {
+    const [name, help] = OPTIONS[flag];
+    const fallback = DEFAULTS[name] !== undefined ? ` (default ${DEFAULTS[name]})` : '';
+    console.log(`  ${flag.padEnd(18)} ${help}${fallback}`);
+  }
+  console.log(`  ${'--fixture'.padEnd(18)} JSON server data {lists, tasks: {listId: [task]}}`);
+  console.log(`  ${'--script'.padEnd(18)} phone script to run (default src/pkjs/index.js)`);
+  console.log(`  ${'--json'.padEnd(18)} print the report as JSON`);
+  console.log(`  ${'--verbose'.padEnd(18)} show the script's console output`);
+}
+
+function parseArgs(argv) {
+  const options = {};
+  let json = false;
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    if (OPTIONS[arg]) {
+      const value = Number(argv[++i]);
+      if (Number.isNaN(value)) throw new Error(`${arg} needs a number`);
+      options[OPTIONS[arg][0]] = value;
+    } else if (arg === '--fixture') {
+      options.data = JSON.parse(fs.readFileSync(argv[++i], 'utf8'));
+    } else if (arg === '--script') {
+      options.script = argv[++i];
+    } else if (arg === '--json') {
+      json = true;
+    } else if (arg === '--verbose') {
+      options.verbose = true;
+    } else if (arg === '--help' || arg === '-h') {
+      usage();
+      process.exit(0);
+    } else if (!arg.startsWith('--') && !options.recording) {
+      options.recording = parseRecording(fs.readFileSync(arg, 'utf8'));
+    } else {
+      throw new Error(`Unknown option ${arg}`);
+    }
+  }
+  return { options, json };
+}
+
+function ms(value) {
+  return value === null ? '-' : `${value}ms`;
+}
+
+function printReport(report) {
+  const o = report.options;
+  console.log(`link: ${o.latencyMs}ms +${o.jitterMs}ms, ${o.bandwidth} B/s, ack ${o.ackRate}, busy ${o.busyRate}, ` +
+              `inbox ${o.inboxSize}, seed ${o.seed}`);
+  console.log('');
+  const launches = report.streams.some(s => s.launch > 1);
+  console.log(`${launches ? 'launch  ' : ''}stream  gen  list                                   ` +
+              'rows      count after full after  frames  bytes');
+  for (const s of report.streams) {
+    const rows = `${s.rows}/${s.expected === null ? '?' : s.expected}`;
+    console.log(`${launches ? String(s.launch).padEnd(8) : ''}` +
+                `${s.type.padEnd(8)}${String(s.generation).padEnd(5)}${String(s.listId || '-').padEnd(39)}` +
+                `${rows.padEnd(10)}${ms(s.countAfterMs).padEnd(12)}${ms(s.timeToFullMs).padEnd(12)}` +
+                `${String(s.frames).padEnd(8)}${s.bytes}`);
+  }
+  for (const n of report.notes) {
+    console.log(`notes of ${n.taskId}: ${n.timeToNotesMs === null ? 'never arrived' : `after ${n.timeToNotesMs}ms`}`);
+  }
+  const link = report.link;
+  const reasons = Object.keys(link.nackReasons).map(r => `${r} ${link.nackReasons[r]}`).join(', ');
+  console.log('');
+  console.log(`phone -> watch: ${link.sends} sends, ${link.acks} acks, ${link.nacks} nacks${reasons ? ` (${reasons})` : ''}, ` +
+              `${link.bytes} bytes`);
+  console.log(`watch -> phone: ${link.watchSends} messages, ${link.staleMessages} stale messages dropped`);
+  console.log(`server: ${report.serverRequests} requests, ${link.aborts} aborted; done at ${report.endMs}ms`);
+  if (!report.streams.length) {
+    console.log('no streams: the watch never got the ready message');
+  }
+}
+
+function main() {
+  let parsed;
+  try {
+    parsed = parseArgs(process.argv.slice(2));
+  } catch (e) {
+    console.error(e.message);
+    usage();
+    process.exit(2);
+  }
+  const report = new Simulation(parsed.options).run();
+  if (parsed.json) {
+    console.log(JSON.stringify(report, null, 2));
+  } else {
+    printReport(report);
+  }
+  // A scripted run fails unless the list it opened arrived in full, so
+  // scripts can gate on it
+  const opened = report.streams.filter(s => s.type === 'tasks');
+  const failed = !opened.length || opened.some(s => s.timeToFullMs === null);
+  process.exit(failed && !parsed.options.recording ? 1 : 0);
+}
+
+main();
@@ -0,0 +1,634 @@
+/**
+ * Deterministic simulation of the phone side (src/pkjs/index.js, unmodified)
+ * talking to a simulated watch over a simulated Bluetooth link, with a fake
+ * task server behind XMLHttpRequest. Time is virtual: timers, link latency and
+ * server latency advance a clock instead of waiting, so a run is repeatable
+ * for a given seed and takes milliseconds.
+ */
+
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+
+const REPO_ROOT = path.join(__dirname, '..', '..');
+const EPOCH_MS = Date.UTC(2026, 0, 1);
+
+// Must match the watch (task_manager.h, request_queue.c)
+const KEY_RECORD_BASE = 100;
+const TASKS_WINDOW_ROWS = 48;
+const DICT_HEADER_SIZE = 1;
+const TUPLE_HEADER_SIZE = 7;
+const RECORD_FLAG_UUID_ID = 0x10;
+
+const DEFAULTS = {
+  seed: 1,
+  latencyMs: 30,        // one way, phone <-> watch
+  jitterMs: 10,         // added uniformly to each hop
+  bandwidth: 4000,      // link bytes per second
+  ackRate: 1,           // share of messages the watch acknowledges
+  busyRate: 0,          // share NACKed with APP_MSG_BUSY
+  nackDelayMs: 1000,    // time until a lost message is reported as failed
+  processMs: 4,         // watch time to handle one message
+  inboxSize: 8192,      // watch AppMessage inbox (1024 on aplite)
+  serverLatencyMs: 100,
+  serverTaskMs: 1,      // provider time per task of a list
+  serverPageTasks: 100, // tasks per provider page in NDJSON streams
+  untilMs: 10 * 60 * 1000,
+  openList: 0,          // list the scripted watch opens once lists arrive
+  thinkMs: 0,           // time the scripted user takes to pick that list
+  openNotes: 0,         // 1: the scripted user then opens the first task's notes
+  launches: 1,          // scripted app launches, sharing the phone's localStorage
+  script: path.join(REPO_ROOT, 'src', 'pkjs', 'index.js'),
+  verbose: false
+};
+
+// mulberry32: small seeded PRNG so injected failures repeat
+function createRandom(seed) {
+  let state = seed >>> 0;
+  return function random() {
+    state = (state + 0x6D2B79F5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+class Clock {
+  constructor() {
+    this.now = 0;
+    this.queue = [];
+    this.nextId = 1;
+  }
+
+  after(delayMs, callback) {
+    const event = { id: this.nextId++, time: this.now + Math.max(0, delayMs || 0), callback };
+    // Keep the queue ordered by time, then by scheduling order
+    let i = this.queue.length;
+    while (i > 0 && this.queue[i - 1].time > event.time) i--;
+    this.queue.splice(i, 0, event);
+    return event.id;
+  }
+
+  cancel(id) {
+    const i = this.queue.findIndex(event => event.id === id);
+    if (i >= 0) this.queue.splice(i, 1);
+  }
+
+  run(untilMs) {
+    while (this.queue.length && this.queue[0].time <= untilMs) {
+      const event = this.queue.shift();
+      this.now = event.time;
+      event.callback();
+    }
+  }
+}
+
+function messageKeys() {
+  const pkg = JSON.parse(fs.readFileSync(path.join(REPO_ROOT, 'package.json'), 'utf8'));
+  return pkg.pebble.messageKeys;
+}
+
+function utf8Length(str) {
+  return Buffer.byteLength(String(str), 'utf8');
+}
+
+// Serialized size of a dictionary, as the watch inbox sees it
+function dictSize(dict) {
+  let size = DICT_HEADER_SIZE;
+  for (const key of Object.keys(dict)) {
+    const value = dict[key];
+    if (typeof value === 'string') size += TUPLE_HEADER_SIZE + utf8Length(value) + 1;
+    else if (value && value.length !== undefined) size += TUPLE_HEADER_SIZE + value.length;
+    else size += TUPLE_HEADER_SIZE + 4;
+  }
+  return size;
+}
+
+function uuidString(bytes) {
+  const hex = Array.from(bytes, b => b.toString(16).padStart(2, '0')).join('').toUpperCase();
+  return `${hex.slice(0, 8)}-${hex.slice(8, 12)}-${hex.slice(12, 16)}-${hex.slice(16, 20)}-${hex.slice(20)}`;
+}
+
+// Id of a binary record (see record.h)
+function recordId(bytes) {
+  const idLength = bytes[6];
+  const id = bytes.slice(7, 7 + idLength);
+  return (bytes[1] & RECORD_FLAG_UUID_ID) ? uuidString(id) : Buffer.from(id).toString('utf8');
+}
+
+// Server data: {lists: [{id, name}], tasks: {listId: [task]}}
+function syntheticData(listCount, taskCount) {
+  const lists = [];
+  const tasks = {};
+  for (let l = 0; l < listCount; l++) {
+    const id = `list-${l}`;
+    lists.push({ id, name: `List ${l}` });
+    tasks[id] = [];
+    for (let i = 0; i < taskCount; i++) {
+      const hex = ((l + 1) * 100000 + i).toString(16).toUpperCase().padStart(12, '0');
+      tasks[id].push({
+        id: `0000ABCD-0000-4000-8000-${hex}`,
+        name: `Task ${i} of list ${l}`,
+        completed: false,
+        priority: i % 10,
+        dueDate: i % 2 ? null : `2026-02-${String(1 + (i % 28)).padStart(2, '0')}T09:00:00`,
+        dueEpoch: i % 2 ? null : Date.UTC(2026, 1, 1 + (i % 28), 9) / 1000,
+        allDay: false
+      });
+    }
+  }
+  return { lists, tasks };
+}
+
+class FakeServer {
+  constructor(sim, data) {
+    this.sim = sim;
+    this.data = data;
+    this.versions = {};
+    this.requests = 0;
+  }
+
+  version(listId) {
+    if (!this.versions[listId]) this.versions[listId] = 1767225600 + Object.keys(this.versions).length;
+    return this.versions[listId];
+  }
+
+  // Response to a request: {status, body, delayMs} after the server latency,
+  // or {status, chunks: [{delayMs, text}]} for a stream
+  handle(method, url, headers) {
+    this.requests++;
+    const { pathname, searchParams } = new URL(url);
+    let match;
+    if (method === 'GET' && pathname === '/api/lists') {
+      return { status: 200, body: { lists: this.data.lists } };
+    }
+    if (method === 'GET' && (match = pathname.match(/^\/api\/lists\/([^/]+)\/tasks$/))) {
+      const listId = decodeURIComponent(match[1]);
+      const version = this.version(listId);
+      // Like server.js: 50 tasks unless limit says otherwise, 0 for all
+      const limit = searchParams.has('limit') ? parseInt(searchParams.get('limit'), 10) : 50;
+      const all = this.data.tasks[listId] || [];
+      const tasks = limit > 0 ? all.slice(0, limit) : all;
+      const delayMs = tasks.length * this.sim.options.serverTaskMs;
+      if (searchParams.get('stream') === 'ndjson') {
+        return { status: 200, chunks: this.taskChunks(listId, version, tasks) };
+      }
+      if (headers['If-None-Match'] === `"${version}"`) {
+        return { status: 304, body: null, delayMs };
+      }
+      return { status: 200, body: { listId, version, tasks }, delayMs };
+    }
+    if (method === 'GET' && (match = pathname.match(/^\/api\/lists\/([^/]+)\/tasks\/([^/]+)$/))) {
+      const listId = decodeURIComponent(match[1]);
+      const taskId = decodeURIComponent(match[2]);
+      const task = (this.data.tasks[listId] || []).find(t => t.id === taskId) || {};
+      return { status: 200, body: { listId, task } };
+    }
+    if (method === 'PATCH' && /\/complete$/.test(pathname)) {
+      return { status: 200, body: { success: true } };
+    }
+    if (method === 'POST' && pathname === '/api/trace') {
+      return { status: 201, body: {} };
+    }
+    return { status: 404, body: { error: 'Route not found' } };
+  }
+
+  // NDJSON lines of a task stream, a provider page at a time
+  taskChunks(listId, version, tasks) {
+    const chunks = [];
+    const pageTasks = this.sim.options.serverPageTasks;
+    for (let first = 0; first < tasks.length || !chunks.length; first += pageTasks) {
+      const page = tasks.slice(first, first + pageTasks);
+      chunks.push({
+        delayMs: (first + page.length) * this.sim.options.serverTaskMs,
+        text: page.map(task => JSON.stringify({ type: 'task', task }) + '\n').join('')
+      });
+    }
+    chunks[chunks.length - 1].text += JSON.stringify({ type: 'end', listId, count: tasks.length, version }) + '\n';
+    return chunks;
+  }
+
+  // XMLHttpRequest for the script's context
+  xhrClass() {
+    const server = this;
+    const sim = this.sim;
+    return class XMLHttpRequest {
+      constructor() {
+        this.readyState = 0;
+        this.status = 0;
+        this.responseText = '';
+        this.headers = {};
+        this.aborted = false;
+      }
+      open(method, url) {
+        this.method = method;
+        this.url = url;
+        this.readyState = 1;
+      }
+      setRequestHeader(name, value) {
+        this.headers[name] = value;
+      }
+      send() {
+        const response = server.handle(this.method, this.url, this.headers);
+        const chunks = response.chunks ||
+          [{ delayMs: response.delayMs || 0, text: response.body ? JSON.stringify(response.body) : '' }];
+        this.timers = chunks.map((chunk, i) => sim.clock.after(sim.options.serverLatencyMs + chunk.delayMs, () => {
+          const last = i === chunks.length - 1;
+          this.status = response.status;
+          this.responseText += chunk.text;
+          this.readyState = last ? 4 : 3;
+          if (last && this.onload) this.onload();
+          if (!last && this.onprogress) this.onprogress();
+        }));
+      }
+      abort() {
+        this.aborted = true;
+        sim.stats.aborts++;
+        this.timers.forEach(timer => sim.clock.cancel(timer));
+        if (this.onabort) this.onabort();
+      }
+    };
+  }
+}
+
+/**
+ * The watch app as the phone sees it: answers type 0 with a list request,
+ * opens a list once the lists arrive, and tracks every stream until all of
+ * its rows arrived. Messages of a superseded generation are dropped and
+ * cancelled, as task_manager.c does.
+ */
+class SimulatedWatch {
+  constructor(sim, scripted, launch) {
+    this.sim = sim;
+    this.scripted = scripted;
+    this.launch = launch;
+    this.generation = 0;
+    this.current = {};      // message type -> generation of its live stream
+    this.cancelled = {};
+    this.streams = [];
+    this.listIds = [];
+    this.notes = [];        // notes requests: {listId, taskId, requestedAt, receivedAt}
+    this.busyUntil = 0;
+    this.ready = false;
+  }
+
+  stream(type, generation) {
+    return this.streams.find(s => s.type === type && s.generation === generation);
+  }
+
+  openStream(type, generation, listId) {
+    this.current[type] = generation;
+    const stream = {
+      type, generation, listId, launch: this.launch,
+      requestedAt: this.sim.clock.now,
+      countAt: null, completeAt: null,
+      count: null, expected: null, streaming: false,
+      rows: new Set(), frames: 0, bytes: 0
+    };
+    this.streams.push(stream);
+    return stream;
+  }
+
+  request(type, fields) {
+    const generation = ++this.generation;
+    const payload = Object.assign({ KEY_TYPE: type }, fields, {
+      KEY_INBOX_SIZE: this.sim.options.inboxSize,
+      KEY_GENERATION: generation
+    });
+    this.openStream(type, generation, fields.KEY_ID);
+    this.sim.link.watchSend(payload);
+  }
+
+  // A message recorded from a real watch, sent at its recorded time
+  inject(payload) {
+    if ((payload.KEY_TYPE === 1 || payload.KEY_TYPE === 2) && payload.KEY_GENERATION !== undefined) {
+      this.generation = Math.max(this.generation, payload.KEY_GENERATION);
+      this.openStream(payload.KEY_TYPE, payload.KEY_GENERATION, payload.KEY_ID);
+    }
+    this.sim.link.watchSend(payload);
+  }
+
+  receive(payload, size) {
+    const type = payload.KEY_TYPE;
+    if (type === 0) {
+      // Like task_manager.c, a resent ready is ignored
+      if (this.scripted && !this.ready) this.request(1, {});
+      this.ready = true;
+      return;
+    }
+    if (type === 5) {
+      const notes = this.notes.find(n => n.taskId === payload.KEY_ID && n.receivedAt === null);
+      if (notes) notes.receivedAt = this.sim.clock.now;
+      return;
+    }
+    if (type !== 1 && type !== 2) {
+      return;
+    }
+
+    const generation = payload.KEY_GENERATION;
+    if (generation !== undefined && generation !== this.current[type]) {
+      this.sim.stats.staleMessages++;
+      if (!this.cancelled[generation]) {
+        this.cancelled[generation] = true;
+        this.sim.link.watchSend({ KEY_TYPE: 7, KEY_GENERATION: generation });
+      }
+      return;
+    }
+
+    const stream = this.stream(type, this.current[type]);
+    if (!stream) {
+      return;
+    }
+    stream.bytes += size;
+
+    if (payload.KEY_TOTAL !== undefined && payload.KEY_COUNT === undefined) {
+      // Length of a streamed list: the rows known so far, or with a version the final one
+      if (!stream.streaming) return;
+      stream.count = Math.max(stream.count, payload.KEY_TOTAL);
+      if (payload.KEY_VERSION === undefined) return;
+      stream.streaming = false;
+      stream.expected = Math.min(stream.count, TASKS_WINDOW_ROWS);
+    } else if (payload.KEY_COUNT !== undefined) {
+      stream.count = payload.KEY_COUNT;
+      // A streamed list's length is not known until its final KEY_TOTAL
+      stream.streaming = payload.KEY_TOTAL !== undefined;
+      stream.expected = stream.streaming ? null : type === 2 ? Math.min(stream.count, TASKS_WINDOW_ROWS) : stream.count;
+      stream.countAt = this.sim.clock.now;
+      if (payload.KEY_LAYOUT) {
+        // Delta: only the new rows follow
+        stream.expected = this.layoutNewRows(payload.KEY_LAYOUT);
+      }
+    } else {
+      stream.frames++;
+      const first = payload.KEY_IDX || 0;
+      for (let n = 0; n < (payload.KEY_BATCH || 0); n++) {
+        stream.rows.add(first + n);
+        if (stream.streaming) stream.count = Math.max(stream.count, first + n + 1);
+        if (type === 1 && first + n === this.listIds.length) {
+          this.listIds.push(recordId(payload[KEY_RECORD_BASE + n]));
+        }
+      }
+    }
+
+    if (stream.completeAt === null && stream.expected !== null && stream.rows.size >= stream.expected) {
+      stream.completeAt = this.sim.clock.now;
+      this.streamComplete(stream);
+    }
+  }
+
+  layoutNewRows(layout) {
+    let rows = 0;
+    for (let i = 0; i + 4 <= layout.length; i += 4) {
+      if ((layout[i] | (layout[i + 1] << 8)) === 0xFFFF) rows += layout[i + 2] | (layout[i + 3] << 8);
+    }
+    return rows;
+  }
+
+  streamComplete(stream) {
+    if (this.scripted && stream.type === 1 && this.listIds.length > this.sim.options.openList) {
+      this.sim.clock.after(this.sim.options.thinkMs, () => this.request(2, {
+        KEY_ID: this.listIds[this.sim.options.openList],
+        KEY_VERSION: 0,
+        KEY_COUNT: TASKS_WINDOW_ROWS
+      }));
+    }
+    if (this.scripted && stream.type === 2 && this.sim.options.openNotes && !this.notes.length) {
+      // The task id as the detail view sends it; the watch waits for the reply
+      const task = (this.sim.data.tasks[stream.listId] || [])[0];
+      if (!task) return;
+      this.notes.push({ listId: stream.listId, taskId: task.id, requestedAt: this.sim.clock.now, receivedAt: null });
+      this.sim.clock.after(this.sim.options.thinkMs, () => this.sim.link.watchSend({
+        KEY_TYPE: 5,
+        KEY_LIST_ID: stream.listId,
+        KEY_ID: task.id
+      }));
+    }
+  }
+}
+
+/**
+ * The Bluetooth link. Phone-to-watch messages go one at a time: each takes
+ * latency plus transfer time, then is ACKed after the watch handled it, or
+ * NACKed (BUSY, lost, or too large for the inbox).
+ */
+class SimulatedLink {
+  constructor(sim) {
+    this.sim = sim;
+    this.queue = [];
+    this.sending = false;
+  }
+
+  hop() {
+    const { latencyMs, jitterMs } = this.sim.options;
+    return latencyMs + this.sim.random() * jitterMs;
+  }
+
+  phoneSend(dict, onAck, onNack) {
+    this.queue.push({ dict, onAck, onNack });
+    this.pump();
+  }
+
+  pump() {
+    if (this.sending || !this.queue.length) {
+      return;
+    }
+    this.sending = true;
+    const message = this.queue.shift();
+    const payload = this.sim.named(message.dict);
+    const size = dictSize(message.dict);
+    const { options, stats, clock } = this.sim;
+    stats.sends++;
+    stats.bytes += size;
+
+    const finish = (ok, error, delay) => {
+      clock.after(delay, () => {
+        this.sending = false;
+        if (ok) {
+          stats.acks++;
+          if (message.onAck) message.onAck({ data: { transactionId: stats.sends } });
+        } else {
+          stats.nacks++;
+          stats.nackReasons[error] = (stats.nackReasons[error] || 0) + 1;
+          if (message.onNack) message.onNack({ data: { transactionId: stats.sends }, error: { message: error } });
+        }
+        this.pump();
+      });
+    };
+
+    clock.after(this.hop() + size * 1000 / options.bandwidth, () => {
+      const roll = this.sim.random();
+      const watch = this.sim.watch;
+      if (size > options.inboxSize) {
+        finish(false, 'APP_MSG_BUFFER_OVERFLOW', this.hop());
+      } else if (roll < options.busyRate || clock.now < watch.busyUntil) {
+        finish(false, 'APP_MSG_BUSY', this.hop());
+      } else if (roll < options.busyRate + (1 - options.ackRate)) {
+        finish(false, 'APP_MSG_SEND_TIMEOUT', options.nackDelayMs);
+      } else {
+        watch.busyUntil = clock.now + options.processMs;
+        watch.receive(payload, size);
+        finish(true, null, options.processMs + this.hop());
+      }
+    });
+  }
+
+  // Watch-to-phone messages; only their latency is modelled
+  watchSend(payload) {
+    this.sim.stats.watchSends++;
+    this.sim.clock.after(this.hop(), () => this.sim.deliverToPhone(payload));
+  }
+}
+
+class Simulation {
+  constructor(options) {
+    this.options = Object.assign({}, DEFAULTS, options);
+    this.random = createRandom(this.options.seed);
+    this.clock = new Clock();
+    this.keys = messageKeys();
+    this.keyNames = {};
+    for (const name of Object.keys(this.keys)) this.keyNames[this.keys[name]] = name;
+    this.stats = {
+      sends: 0, acks: 0, nacks: 0, nackReasons: {}, bytes: 0,
+      watchSends: 0, staleMessages: 0, aborts: 0
+    };
+    this.storage = {};      // the phone's localStorage, kept across launches
+    this.streams = [];
+    this.notes = [];
+    this.data = this.options.data || syntheticData(this.options.lists || 3, this.options.tasks || 100);
+    this.server = new FakeServer(this, this.data);
+    this.link = new SimulatedLink(this);
+  }
+
+  // A fresh watch app and phone script, as when the app is opened
+  launch(n) {
+    this.watch = new SimulatedWatch(this, !this.options.recording, n);
+    this.listeners = {};
+    this.loadScript();
+  }
+
+  // Dictionary keyed by names, as the watch reads it (record keys stay numbers)
+  named(dict) {
+    const named = {};
+    for (const key of Object.keys(dict)) {
+      named[this.keyNames[key] || key] = dict[key];
+    }
+    return named;
+  }
+
+  loadScript() {
+    const sim = this;
+    const storage = this.storage;
+    const log = this.options.verbose ? (...args) => console.log(`[${sim.clock.now}ms]`, ...args) : () => {};
+
+    class VirtualDate extends Date {
+      constructor(...args) {
+        if (args.length) super(...args);
+        else super(EPOCH_MS + sim.clock.now);
+      }
+      static now() {
+        return EPOCH_MS + sim.clock.now;
+      }
+    }
+
+    const context = {
+      console: { log, warn: log, error: log, info: log },
+      setTimeout: (callback, ms) => sim.clock.after(ms, callback),
+      clearTimeout: id => sim.clock.cancel(id),
+      Date: VirtualDate,
+      localStorage: {
+        getItem: key => (key in storage ? storage[key] : null),
+        setItem: (key, value) => { storage[key] = String(value); },
+        removeItem: key => { delete storage[key]; }
+      },
+      require: name => {
+        if (name === 'message_keys') return sim.keys;
+        throw new Error(`Cannot require ${name} in PebbleKit JS`);
+      },
+      XMLHttpRequest: this.server.xhrClass(),
+      Pebble: {
+        addEventListener: (event, callback) => { sim.listeners[event] = callback; },
+        sendAppMessage: (dict, onAck, onNack) => sim.link.phoneSend(dict, onAck, onNack),
+        getActiveWatchInfo: () => ({ platform: 'simulated' }),
+        openURL: () => {}
+      }
+    };
+    vm.createContext(context);
+    vm.runInContext(fs.readFileSync(this.options.script, 'utf8'), context, { filename: this.options.script });
+  }
+
+  deliverToPhone(payload) {
+    const numbered = {};
+    for (const name of Object.keys(payload)) {
+      numbered[name] = payload[name];
+      if (this.keys[name] !== undefined) numbered[this.keys[name]] = payload[name];
+    }
+    if (this.listeners.appmessage) this.listeners.appmessage({ payload: numbered });
+  }
+
+  run() {
+    const launches = this.options.recording ? 1 : Math.max(1, this.options.launches);
+    for (let n = 1; n <= launches; n++) {
+      const start = this.clock.now;
+      this.launch(n);
+      this.clock.after(0, () => this.listeners.ready && this.listeners.ready({}));
+      for (const entry of this.options.recording || []) {
+        // Cancels were the real watch's reaction to its own timing; ours sends its own
+        if (entry.event === 'receive' && entry.payload.KEY_TYPE !== 7) {
+          this.clock.after(entry.t, () => this.watch.inject(entry.payload));
+        }
+      }
+      this.clock.run(start + this.options.untilMs);
+      this.streams.push(...this.watch.streams);
+      this.notes.push(...this.watch.notes);
+    }
+    return this.report();
+  }
+
+  report() {
+    const streams = this.streams.map(s => ({
+      launch: s.launch,
+      type: s.type === 1 ? 'lists' : 'tasks',
+      generation: s.generation,
+      listId: s.listId || null,
+      count: s.count,
+      rows: s.rows.size,
+      expected: s.expected,
+      frames: s.frames,
+      bytes: s.bytes,
+      requestedAtMs: Math.round(s.requestedAt),
+      countAfterMs: s.countAt === null ? null : Math.round(s.countAt - s.requestedAt),
+      timeToFullMs: s.completeAt === null ? null : Math.round(s.completeAt - s.requestedAt)
+    }));
+    return {
+      options: Object.assign({}, this.options, { data: undefined, recording: undefined }),
+      endMs: Math.round(this.clock.now),
+      streams,
+      notes: this.notes.map(n => ({
+        listId: n.listId,
+        taskId: n.taskId,
+        timeToNotesMs: n.receivedAt === null ? null : Math.round(n.receivedAt - n.requestedAt)
+      })),
+      link: Object.assign({ retries: this.stats.nacks }, this.stats),
+      serverRequests: this.server.requests
+    };
+  }
+}
+
+// Entries of a recording: "[rec] {json}" lines from the phone log, or plain JSON lines
+function parseRecording(text) {
+  const entries = [];
+  for (const line of text.split('\n')) {
+    const i = line.indexOf('[rec] ');
+    const json = i >= 0 ? line.slice(i + 6) : line.trim();
+    if (!json.startsWith('{')) continue;
+    try {
+      entries.push(JSON.parse(json));
+    } catch (e) {
+      // not a recorder line
+    }
+  }
+  return entries;
+}
+
+module.exports = { Simulation, parseRecording, syntheticData, dictSize, DEFAULTS };